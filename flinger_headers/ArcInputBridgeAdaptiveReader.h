@@ -0,0 +1,311 @@
+/*
+ * Copyright 2026 The Chromium Authors.
+ *
+ * Permission is hereby granted, free of charge, to any person obtaining a
+ * copy of this software and associated documentation files (the "Software"),
+ * to deal in the Software without restriction, including without limitation
+ * the rights to use, copy, modify, merge, publish, distribute, sublicense,
+ * and/or sell copies of the Software, and to permit persons to whom the
+ * Software is furnished to do so, subject to the following conditions:
+ *
+ * The above copyright notice and this permission notice (including the next
+ * paragraph) shall be included in all copies or substantial portions of the
+ * Software.
+ *
+ * THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+ * IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+ * FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL
+ * THE AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+ * LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING
+ * FROM, OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER
+ * DEALINGS IN THE SOFTWARE.
+ */
+#ifndef _RUNTIME_ARC_INPUT_BRIDGE_ADAPTIVE_READER_H
+#define _RUNTIME_ARC_INPUT_BRIDGE_ADAPTIVE_READER_H
+
+#include <fcntl.h>
+#include <sys/epoll.h>
+#include <unistd.h>
+
+#include <algorithm>
+#include <cerrno>
+#include <cstddef>
+#include <cstdint>
+
+#include "ArcInputBridgeClock.h"
+#include "ArcInputBridgeLatency.h"
+#include "ArcInputBridgeProtocol.h"
+#include "ArcInputBridgeStream.h"
+
+namespace arc {
+
+struct BridgeInputAdaptiveReaderStats {
+    uint64_t reads;
+    // Reads that found events already waiting in the pipe.
+    uint64_t immediate;
+    // Reads satisfied while busy-polling.
+    uint64_t spinHits;
+    // Busy-poll windows that expired without data and fell back to epoll.
+    uint64_t spinMisses;
+    // Reads that had to sleep in epoll_wait().
+    uint64_t epollWakeups;
+    uint64_t timeouts;
+    // Total time spent busy-polling. This is the CPU paid for the latency won.
+    uint64_t spinNs;
+};
+
+// Consumer side reader for kArcInputBridgePipe that trades CPU for wakeup
+// latency while the user is actively moving something.
+//
+// Streaming events (POINTER_MOVE, POINTER_MOVE_RELATIVE, TOUCH_MOVE,
+// GESTURE_PINCH_UPDATE, GESTURE_SWIPE_UPDATE) arrive every few milliseconds,
+// and sleeping in the kernel between them costs a scheduler wakeup each time.
+// After such an event the reader busy-polls the pipe for up to twice the
+// average gap between streaming reads, bounded by Options::maxSpinNs, before
+// falling back to epoll_wait(). When the stream is sparser than maxSpinNs the
+// spin would mostly miss, so it is skipped. A gesture end, TOUCH_CANCEL or
+// RESET ends the active period.
+//
+// Busy-polling only pays off when the consumer thread has a core to itself;
+// set maxSpinNs to 0 on small devices to get a plain epoll reader.
+//
+// Wakeup latency, the time from an event's timestamp to its read, is
+// recorded separately for reads served by the spin and by epoll, so the
+// effect of maxSpinNs can be measured in the field.
+class BridgeInputAdaptiveReader {
+public:
+    struct Options {
+        // Upper bound on a single busy-poll window. 0 disables busy-polling.
+        uint64_t maxSpinNs = 2'000'000;
+    };
+
+    // Does not take ownership of |fd|, which is switched to non-blocking mode.
+    // O_NONBLOCK belongs to the open file description, so every other fd
+    // that shares it (dup()s, fork()ed copies) becomes non-blocking too and
+    // stays that way after the reader is destroyed. Pass an fd that nothing
+    // else reads with blocking calls.
+    explicit BridgeInputAdaptiveReader(int fd) : BridgeInputAdaptiveReader(fd, Options()) {}
+    BridgeInputAdaptiveReader(int fd, const Options& options) : mFd(fd), mOptions(options) {
+        int flags = fcntl(mFd, F_GETFL);
+        if (flags >= 0) {
+            fcntl(mFd, F_SETFL, flags | O_NONBLOCK);
+        }
+        mEpollFd = epoll_create1(EPOLL_CLOEXEC);
+        if (mEpollFd >= 0) {
+            epoll_event ev{};
+            ev.events = EPOLLIN;
+            ev.data.fd = mFd;
+            if (epoll_ctl(mEpollFd, EPOLL_CTL_ADD, mFd, &ev) != 0) {
+                close(mEpollFd);
+                mEpollFd = -1;
+            }
+        }
+    }
+
+    ~BridgeInputAdaptiveReader() {
+        if (mEpollFd >= 0) {
+            close(mEpollFd);
+        }
+    }
+
+    BridgeInputAdaptiveReader(const BridgeInputAdaptiveReader&) = delete;
+    BridgeInputAdaptiveReader& operator=(const BridgeInputAdaptiveReader&) = delete;
+
+    bool IsValid() const { return mEpollFd >= 0; }
+
+    // Reads up to |maxEvents| whole events into |events|, waiting at most
+    // |timeoutMs| for the first one; a negative timeout waits forever.
+    // Returns the number of events read, 0 on EOF or -1 on error (errno is
+    // set, EAGAIN if the timeout expired and EBADMSG if the stream can't be
+    // decoded any further, see BridgeInputStreamDecoder::corrupt()).
+    ssize_t Read(BridgeInputEvent* events, size_t maxEvents, int timeoutMs = -1) {
+        if (maxEvents == 0) {
+            return 0;
+        }
+        mStats.reads++;
+        ssize_t count = TryRead(events, maxEvents);
+        if (count != 0 || errno != EAGAIN) {
+            mStats.immediate += count > 0;
+            return Finish(events, count, nullptr);
+        }
+
+        uint64_t start = BridgeInputNowNs();
+        uint64_t deadline = timeoutMs < 0 ? UINT64_MAX : start + uint64_t(timeoutMs) * 1'000'000;
+        uint64_t spinEnd = std::min(SpinDeadline(), deadline);
+        if (spinEnd > start) {
+            uint64_t now = start;
+            do {
+                count = TryRead(events, maxEvents);
+                now = BridgeInputNowNs();
+            } while (count == 0 && errno == EAGAIN && now < spinEnd);
+            mStats.spinNs += now - start;
+            if (count != 0 || errno != EAGAIN) {
+                mStats.spinHits += count > 0;
+                return Finish(events, count, &mSpinLatency);
+            }
+            mStats.spinMisses++;
+        }
+
+        for (;;) {
+            uint64_t now = BridgeInputNowNs();
+            int waitMs = -1;
+            if (deadline != UINT64_MAX) {
+                if (now >= deadline) {
+                    mStats.timeouts++;
+                    errno = EAGAIN;
+                    return -1;
+                }
+                // Round up so that a sub-millisecond remainder doesn't spin.
+                waitMs = static_cast<int>((deadline - now + 999'999) / 1'000'000);
+            }
+            epoll_event ev;
+            int ret = TEMP_FAILURE_RETRY(epoll_wait(mEpollFd, &ev, 1, waitMs));
+            if (ret < 0) {
+                return -1;
+            }
+            if (ret == 0) {
+                continue;
+            }
+            count = TryRead(events, maxEvents);
+            if (count != 0 || errno != EAGAIN) {
+                mStats.epollWakeups += count > 0;
+                return Finish(events, count, &mEpollLatency);
+            }
+            // Woken by a partial event; wait for the rest of it.
+        }
+    }
+
+    // Average gap between reads during the current streaming period, or 0 if
+    // there isn't one.
+    uint64_t averageGapNs() const { return mActive ? mAverageGapNs : 0; }
+
+    const BridgeInputAdaptiveReaderStats& stats() const { return mStats; }
+
+    // Wakeup latency of reads that were served by the busy-poll.
+    const BridgeInputLatencyHistogram& spinLatency() const { return mSpinLatency; }
+
+    // Wakeup latency of reads that had to sleep in epoll_wait().
+    const BridgeInputLatencyHistogram& epollLatency() const { return mEpollLatency; }
+
+    static bool IsStreamingEvent(InputEventType type) {
+        switch (type) {
+            case InputEventType::POINTER_MOVE:
+            case InputEventType::POINTER_MOVE_RELATIVE:
+            case InputEventType::TOUCH_MOVE:
+            case InputEventType::GESTURE_PINCH_UPDATE:
+            case InputEventType::GESTURE_SWIPE_UPDATE:
+                return true;
+            default:
+                return false;
+        }
+    }
+
+    static bool EndsStream(InputEventType type) {
+        switch (type) {
+            case InputEventType::RESET:
+            case InputEventType::TOUCH_CANCEL:
+            case InputEventType::GESTURE_PINCH_END:
+            case InputEventType::GESTURE_SWIPE_END:
+                return true;
+            default:
+                return false;
+        }
+    }
+
+private:
+    // Samples are weighted 1/8 in the running average of the gap.
+    static constexpr uint32_t kGapAverageShift = 3;
+
+    // Hands out events that are already decoded, or else performs one
+    // non-blocking read(). Events beyond |maxEvents| and a trailing partial
+    // record stay in the decoder for the next call. Returns 0 with errno set
+    // to EAGAIN if no whole event is available, and 0 with errno cleared on
+    // EOF.
+    ssize_t TryRead(BridgeInputEvent* events, size_t maxEvents) {
+        size_t count = Decode(events, maxEvents);
+        if (count == 0 && !mDecoder.corrupt()) {
+            ssize_t n = mDecoder.Fill(mFd);
+            if (n < 0) {
+                return errno == EAGAIN ? 0 : -1;
+            }
+            if (n == 0) {
+                errno = 0;
+                return 0;
+            }
+            count = Decode(events, maxEvents);
+        }
+        if (count == 0) {
+            if (mDecoder.corrupt()) {
+                errno = EBADMSG;
+                return -1;
+            }
+            errno = EAGAIN;
+        }
+        return count;
+    }
+
+    size_t Decode(BridgeInputEvent* events, size_t maxEvents) {
+        size_t count = 0;
+        while (count < maxEvents && mDecoder.Next(&events[count])) {
+            count++;
+        }
+        return count;
+    }
+
+    // Updates the activity state and latency histogram after a read.
+    ssize_t Finish(const BridgeInputEvent* events, ssize_t count,
+                   BridgeInputLatencyHistogram* latency) {
+        if (count <= 0) {
+            return count;
+        }
+        uint64_t now = BridgeInputNowNs();
+        if (latency) {
+            latency->Record(now > events[0].timestamp ? now - events[0].timestamp : 0);
+        }
+        bool streaming = false;
+        bool ended = false;
+        for (ssize_t i = 0; i < count; i++) {
+            streaming |= IsStreamingEvent(events[i].type);
+            ended |= EndsStream(events[i].type);
+        }
+        if (streaming && !ended) {
+            if (mActive) {
+                // Clamp so that one long pause doesn't disable spinning for
+                // the rest of the gesture.
+                uint64_t gap = std::min(now - mLastStreamNs, 4 * mOptions.maxSpinNs);
+                mAverageGapNs = mAverageGapNs - (mAverageGapNs >> kGapAverageShift) +
+                        (gap >> kGapAverageShift);
+            } else {
+                mActive = true;
+                mAverageGapNs = mOptions.maxSpinNs / 2;
+            }
+            mLastStreamNs = now;
+        } else if (ended) {
+            mActive = false;
+        }
+        return count;
+    }
+
+    // Returns the time until which to busy-poll, or 0 to go straight to epoll.
+    uint64_t SpinDeadline() const {
+        if (!mActive || mOptions.maxSpinNs == 0 || mAverageGapNs > mOptions.maxSpinNs) {
+            return 0;
+        }
+        return mLastStreamNs + std::min(2 * mAverageGapNs, mOptions.maxSpinNs);
+    }
+
+    int mFd;
+    int mEpollFd = -1;
+    Options mOptions;
+    bool mActive = false;
+    uint64_t mLastStreamNs = 0;
+    uint64_t mAverageGapNs = 0;
+    BridgeInputStreamDecoder mDecoder;
+    BridgeInputAdaptiveReaderStats mStats = {};
+    BridgeInputLatencyHistogram mSpinLatency;
+    BridgeInputLatencyHistogram mEpollLatency;
+};
+
+}  // namespace arc
+
+#endif  // _RUNTIME_ARC_INPUT_BRIDGE_ADAPTIVE_READER_H
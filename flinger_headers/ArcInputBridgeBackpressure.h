@@ -0,0 +1,317 @@
+/*
+ * Copyright 2026 The Chromium Authors.
+ *
+ * Permission is hereby granted, free of charge, to any person obtaining a
+ * copy of this software and associated documentation files (the "Software"),
+ * to deal in the Software without restriction, including without limitation
+ * the rights to use, copy, modify, merge, publish, distribute, sublicense,
+ * and/or sell copies of the Software, and to permit persons to whom the
+ * Software is furnished to do so, subject to the following conditions:
+ *
+ * The above copyright notice and this permission notice (including the next
+ * paragraph) shall be included in all copies or substantial portions of the
+ * Software.
+ *
+ * THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+ * IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+ * FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL
+ * THE AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+ * LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING
+ * FROM, OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER
+ * DEALINGS IN THE SOFTWARE.
+ */
+#ifndef _RUNTIME_ARC_INPUT_BRIDGE_BACKPRESSURE_H
+#define _RUNTIME_ARC_INPUT_BRIDGE_BACKPRESSURE_H
+
+#include <fcntl.h>
+#include <limits.h>
+#include <sys/socket.h>
+#include <sys/stat.h>
+#include <unistd.h>
+
+#include <algorithm>
+#include <cerrno>
+#include <cstddef>
+#include <cstdint>
+#include <vector>
+
+#include "ArcInputBridgeCoalescer.h"
+#include "ArcInputBridgeProtocol.h"
+
+namespace arc {
+
+// What BridgeInputBackpressureWriter does when its queue is full.
+enum class BridgeInputOverflowPolicy {
+    // Drop the oldest move that a later queued move supersedes: a POINTER_MOVE
+    // or TOUCH_MOVE followed by another one for the same display and contact,
+    // or a GAMEPAD_AXIS followed by another one for the same gamepad and axis,
+    // with only moves and frame terminators in between. Any other event, such
+    // as a button, key or TOUCH_UP, is a barrier, as in BridgeInputCoalescer.
+    // POINTER_MOVE_RELATIVE is merged into the next one instead of dropped.
+    // Frame terminators left with an empty frame are dropped as well.
+    // Keys, buttons and all other events are never dropped.
+    DROP_OLDEST_MOVES,
+    // Run BridgeInputCoalescer over the queue, folding move-only frames.
+    COALESCE,
+    // Discard the queue and send RESET so the consumer drops all its state.
+    RESET,
+};
+
+struct BridgeInputBackpressureStats {
+    uint64_t written;
+    uint64_t droppedMoves;
+    uint64_t droppedEmptyFrames;
+    uint64_t coalescedEvents;
+    uint64_t resets;
+    // Events discarded by resets.
+    uint64_t droppedOnReset;
+    uint64_t maxQueued;
+};
+
+// Producer side layer that keeps the compositor's input thread from ever
+// blocking on a slow consumer of kArcInputBridgePipe.
+//
+// The pipe is switched to non-blocking mode. O_NONBLOCK is a property of the
+// open file description, not of the fd, so this also affects every dup() of
+// |fd| and whatever shares it across fork(); don't hand it a description that
+// someone else expects to block on. Events are queued in a bounded
+// queue and written out in chunks of at most PIPE_BUF bytes, which the kernel
+// writes either whole or not at all, so an event is never split. Whatever the
+// pipe doesn't accept stays queued until the next Write() or Flush(); the
+// owner should call Flush() when the fd polls writable while HasPending().
+//
+// When the queue is full the configured policy makes room. DROP_OLDEST_MOVES
+// and COALESCE fall back to a reset if they can't free a slot. After a reset
+// TakeResyncRequest() returns true once; the owner should then re-send
+// whatever state the consumer needs, such as connected gamepads and pressed
+// keys.
+//
+// Writing to a pipe whose consumer has gone away raises SIGPIPE, which kills
+// the process by default. If |fd| is a socket it is written with MSG_NOSIGNAL
+// and only Write() or Flush() reports the failure, but pipes and FIFOs such
+// as kArcInputBridgePipe have no such flag: the owner must ignore or block
+// SIGPIPE before writing to one.
+class BridgeInputBackpressureWriter {
+public:
+    struct Options {
+        size_t capacity = 256;
+        BridgeInputOverflowPolicy policy = BridgeInputOverflowPolicy::DROP_OLDEST_MOVES;
+    };
+
+    // Does not take ownership of |fd|.
+    explicit BridgeInputBackpressureWriter(int fd) : BridgeInputBackpressureWriter(fd, Options()) {}
+    BridgeInputBackpressureWriter(int fd, const Options& options)
+          : mFd(fd), mOptions(options), mCoalescer(CoalescerOptions()) {
+        int flags = fcntl(mFd, F_GETFL);
+        if (flags >= 0) {
+            fcntl(mFd, F_SETFL, flags | O_NONBLOCK);
+        }
+        struct stat st;
+        mIsSocket = fstat(mFd, &st) == 0 && S_ISSOCK(st.st_mode);
+        mQueue.reserve(mOptions.capacity);
+    }
+
+    BridgeInputBackpressureWriter(const BridgeInputBackpressureWriter&) = delete;
+    BridgeInputBackpressureWriter& operator=(const BridgeInputBackpressureWriter&) = delete;
+
+    // Queues |event| and writes out as much as the pipe accepts. Never blocks.
+    // Returns false if the pipe is broken.
+    bool Write(const BridgeInputEvent& event) {
+        BridgeInputEvent incoming = event;
+        if (Queued() >= mOptions.capacity) {
+            Compact();
+            MakeRoom(&incoming);
+        }
+        mQueue.push_back(incoming);
+        if (Queued() > mStats.maxQueued) {
+            mStats.maxQueued = Queued();
+        }
+        return Flush();
+    }
+
+    // Writes out queued events until the queue is empty or the pipe is full.
+    // Returns false if the pipe is broken.
+    bool Flush() {
+        while (mHead < mQueue.size()) {
+            size_t count = std::min(Queued(), kEventsPerWrite);
+            ssize_t n = TEMP_FAILURE_RETRY(WriteEvents(&mQueue[mHead], count));
+            if (n < 0) {
+                return errno == EAGAIN;
+            }
+            // Writes of at most PIPE_BUF bytes are all or nothing.
+            mHead += n / sizeof(BridgeInputEvent);
+            mStats.written += n / sizeof(BridgeInputEvent);
+        }
+        mQueue.clear();
+        mHead = 0;
+        return true;
+    }
+
+    bool HasPending() const { return mHead < mQueue.size(); }
+
+    // Returns true once after each reset.
+    bool TakeResyncRequest() {
+        bool pending = mResyncPending;
+        mResyncPending = false;
+        return pending;
+    }
+
+    const BridgeInputBackpressureStats& stats() const { return mStats; }
+
+private:
+    static constexpr size_t kEventsPerWrite = PIPE_BUF / sizeof(BridgeInputEvent);
+    static_assert(kEventsPerWrite > 0, "a BridgeInputEvent must fit in PIPE_BUF");
+
+    static BridgeInputCoalescer::Options CoalescerOptions() {
+        BridgeInputCoalescer::Options options;
+        options.foldMoveOnlyFrames = true;
+        return options;
+    }
+
+    size_t Queued() const { return mQueue.size() - mHead; }
+
+    ssize_t WriteEvents(const BridgeInputEvent* events, size_t count) const {
+        size_t size = count * sizeof(BridgeInputEvent);
+        if (mIsSocket) {
+            return send(mFd, events, size, MSG_NOSIGNAL);
+        }
+        return write(mFd, events, size);
+    }
+
+    // Drops the already written events from the front of the queue.
+    void Compact() {
+        mQueue.erase(mQueue.begin(), mQueue.begin() + mHead);
+        mHead = 0;
+    }
+
+    // Frees a slot for |incoming|, which may absorb a dropped relative move.
+    void MakeRoom(BridgeInputEvent* incoming) {
+        switch (mOptions.policy) {
+            case BridgeInputOverflowPolicy::DROP_OLDEST_MOVES:
+                if (DropEmptyFrame() || DropOldestMove(incoming)) {
+                    return;
+                }
+                break;
+            case BridgeInputOverflowPolicy::COALESCE: {
+                size_t count = mCoalescer.Coalesce(mQueue.data(), mQueue.size());
+                mStats.coalescedEvents += mQueue.size() - count;
+                mQueue.resize(count);
+                if (count < mOptions.capacity) {
+                    return;
+                }
+                break;
+            }
+            case BridgeInputOverflowPolicy::RESET:
+                break;
+        }
+        mStats.droppedOnReset += mQueue.size();
+        mStats.resets++;
+        mQueue.clear();
+        mQueue.push_back(BridgeInputEvent::ResetEvent(incoming->timestamp));
+        mResyncPending = true;
+    }
+
+    // Drops a frame terminator whose frame is empty, i.e. one preceded by a
+    // terminator of the same type and display with no event of its kind in
+    // between. Events of other kinds, such as keys, may sit in between.
+    bool DropEmptyFrame() {
+        for (size_t i = 1; i < mQueue.size(); i++) {
+            const BridgeInputEvent& frame = mQueue[i];
+            if (!IsFrameTerminator(frame.type)) {
+                continue;
+            }
+            for (size_t j = i; j-- > 0;) {
+                const BridgeInputEvent& previous = mQueue[j];
+                if (previous.type == frame.type && previous.displayId == frame.displayId) {
+                    mQueue.erase(mQueue.begin() + i);
+                    mStats.droppedEmptyFrames++;
+                    return true;
+                }
+                if (IsFramePart(frame.type, previous.type)) {
+                    break;
+                }
+            }
+        }
+        return false;
+    }
+
+    // Whether |type| can belong to a frame terminated by |frame|.
+    static bool IsFramePart(InputEventType frame, InputEventType type) {
+        switch (frame) {
+            case InputEventType::POINTER_FRAME:
+                return type >= InputEventType::POINTER_ENTER &&
+                        type < InputEventType::POINTER_FRAME;
+            case InputEventType::TOUCH_FRAME:
+                return type >= InputEventType::TOUCH_DOWN && type < InputEventType::TOUCH_FRAME;
+            default:
+                return (type >= InputEventType::GAMEPAD_CONNECTED &&
+                        type < InputEventType::GAMEPAD_FRAME) ||
+                        type == InputEventType::GAMEPAD_CONNECTED_REF ||
+                        type == InputEventType::GAMEPAD_SNAPSHOT;
+        }
+    }
+
+    // |incoming| counts as the event after the last queued one.
+    bool DropOldestMove(BridgeInputEvent* incoming) {
+        for (size_t i = 0; i < mQueue.size(); i++) {
+            if (!IsMove(mQueue[i].type)) {
+                continue;
+            }
+            // Only look within the run of moves and move-only frames.
+            for (size_t j = i + 1; j <= mQueue.size(); j++) {
+                BridgeInputEvent& later = j < mQueue.size() ? mQueue[j] : *incoming;
+                if (!IsMove(later.type) && !IsFrameTerminator(later.type)) {
+                    break;
+                }
+                if (Supersedes(later, mQueue[i])) {
+                    if (mQueue[i].type == InputEventType::POINTER_MOVE_RELATIVE) {
+                        later.relativePointer.dx += mQueue[i].relativePointer.dx;
+                        later.relativePointer.dy += mQueue[i].relativePointer.dy;
+                    }
+                    mQueue.erase(mQueue.begin() + i);
+                    mStats.droppedMoves++;
+                    return true;
+                }
+            }
+        }
+        return false;
+    }
+
+    static bool IsMove(InputEventType type) {
+        return type == InputEventType::POINTER_MOVE ||
+                type == InputEventType::POINTER_MOVE_RELATIVE ||
+                type == InputEventType::TOUCH_MOVE || type == InputEventType::GAMEPAD_AXIS;
+    }
+
+    static bool Supersedes(const BridgeInputEvent& later, const BridgeInputEvent& move) {
+        if (later.type != move.type || later.displayId != move.displayId) {
+            return false;
+        }
+        switch (move.type) {
+            case InputEventType::POINTER_MOVE:
+            case InputEventType::POINTER_MOVE_RELATIVE:
+                return true;
+            case InputEventType::TOUCH_MOVE:
+                return later.touch.id == move.touch.id;
+            case InputEventType::GAMEPAD_AXIS:
+                return later.gamepad.id == move.gamepad.id &&
+                        later.gamepad.axis == move.gamepad.axis;
+            default:
+                return false;
+        }
+    }
+
+    const int mFd;
+    const Options mOptions;
+    bool mIsSocket = false;
+    BridgeInputCoalescer mCoalescer;
+    std::vector<BridgeInputEvent> mQueue;
+    // Index of the first event not yet written.
+    size_t mHead = 0;
+    bool mResyncPending = false;
+    BridgeInputBackpressureStats mStats = {};
+};
+
+}  // namespace arc
+
+#endif  // _RUNTIME_ARC_INPUT_BRIDGE_BACKPRESSURE_H
@@ -0,0 +1,261 @@
+/*
+ * Copyright 2026 The Chromium Authors.
+ *
+ * Permission is hereby granted, free of charge, to any person obtaining a
+ * copy of this software and associated documentation files (the "Software"),
+ * to deal in the Software without restriction, including without limitation
+ * the rights to use, copy, modify, merge, publish, distribute, sublicense,
+ * and/or sell copies of the Software, and to permit persons to whom the
+ * Software is furnished to do so, subject to the following conditions:
+ *
+ * The above copyright notice and this permission notice (including the next
+ * paragraph) shall be included in all copies or substantial portions of the
+ * Software.
+ *
+ * THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+ * IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+ * FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL
+ * THE AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+ * LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING
+ * FROM, OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER
+ * DEALINGS IN THE SOFTWARE.
+ */
+#ifndef _RUNTIME_ARC_INPUT_BRIDGE_CAPTURE_H
+#define _RUNTIME_ARC_INPUT_BRIDGE_CAPTURE_H
+
+#include <time.h>
+#include <unistd.h>
+
+#include <cerrno>
+#include <cstddef>
+#include <cstdint>
+#include <cstring>
+#include <functional>
+#include <vector>
+
+#include "ArcInputBridgeClock.h"
+#include "ArcInputBridgeProtocol.h"
+
+namespace arc {
+
+// Captures of a BridgeInputEvent stream, used to reproduce input latency
+// regressions offline.
+//
+// A capture is a BridgeInputCaptureHeader followed by events in the compact
+// wire format (see BridgeInputEvent::EncodeCompact). The header records the
+// sizes of the structs the capture was made with, and readers refuse captures
+// whose layout doesn't match their own.
+
+static constexpr char kArcInputBridgeCaptureMagic[8] = {'A', 'R', 'C', 'I', 'B', 'C', 'A', 'P'};
+static constexpr uint32_t kArcInputBridgeCaptureVersion = 1;
+
+struct BridgeInputCaptureHeader {
+    char magic[8];
+    uint32_t version;
+    uint32_t headerSize;
+    uint8_t wireVersion;
+    uint8_t inputEventTypeCount;
+    uint16_t eventSize;
+    uint16_t compactHeaderSize;
+    uint16_t maxCompactSize;
+} __attribute__((packed));
+
+static inline BridgeInputCaptureHeader MakeBridgeInputCaptureHeader() {
+    BridgeInputCaptureHeader header{};
+    memcpy(header.magic, kArcInputBridgeCaptureMagic, sizeof(header.magic));
+    header.version = kArcInputBridgeCaptureVersion;
+    header.headerSize = sizeof(BridgeInputCaptureHeader);
+    header.wireVersion = kArcInputBridgeWireVersionCompact;
+    header.inputEventTypeCount = kInputEventTypeCount;
+    header.eventSize = sizeof(BridgeInputEvent);
+    header.compactHeaderSize = sizeof(BridgeInputEventCompactHeader);
+    header.maxCompactSize = BridgeInputEvent::kMaxCompactSize;
+    return header;
+}
+
+static inline bool BridgeInputCaptureReadFully(int fd, void* data, size_t size) {
+    uint8_t* p = static_cast<uint8_t*>(data);
+    while (size > 0) {
+        ssize_t n = TEMP_FAILURE_RETRY(read(fd, p, size));
+        if (n <= 0) {
+            return false;
+        }
+        p += n;
+        size -= n;
+    }
+    return true;
+}
+
+static inline bool BridgeInputCaptureWriteFully(int fd, const void* data, size_t size) {
+    const uint8_t* p = static_cast<const uint8_t*>(data);
+    while (size > 0) {
+        ssize_t n = TEMP_FAILURE_RETRY(write(fd, p, size));
+        if (n <= 0) {
+            return false;
+        }
+        p += n;
+        size -= n;
+    }
+    return true;
+}
+
+// Appends events to a capture file. Events are buffered and written in
+// chunks, so Flush() must be called before the fd is closed.
+class BridgeInputCaptureWriter {
+public:
+    explicit BridgeInputCaptureWriter(int fd) : mFd(fd) { mBuffer.reserve(kFlushSize); }
+    ~BridgeInputCaptureWriter() { Flush(); }
+
+    BridgeInputCaptureWriter(const BridgeInputCaptureWriter&) = delete;
+    BridgeInputCaptureWriter& operator=(const BridgeInputCaptureWriter&) = delete;
+
+    bool WriteHeader() {
+        BridgeInputCaptureHeader header = MakeBridgeInputCaptureHeader();
+        return BridgeInputCaptureWriteFully(mFd, &header, sizeof(header));
+    }
+
+    bool Append(const BridgeInputEvent& event) {
+        size_t offset = mBuffer.size();
+        mBuffer.resize(offset + event.CompactSize());
+        event.EncodeCompact(mBuffer.data() + offset, mBuffer.size() - offset);
+        return mBuffer.size() < kFlushSize || Flush();
+    }
+
+    bool Flush() {
+        bool ok = BridgeInputCaptureWriteFully(mFd, mBuffer.data(), mBuffer.size());
+        mBuffer.clear();
+        return ok;
+    }
+
+private:
+    static constexpr size_t kFlushSize = 64 * 1024;
+
+    int mFd;
+    std::vector<uint8_t> mBuffer;
+};
+
+// Reads events back from a capture file.
+class BridgeInputCaptureReader {
+public:
+    explicit BridgeInputCaptureReader(int fd) : mFd(fd) {}
+
+    BridgeInputCaptureReader(const BridgeInputCaptureReader&) = delete;
+    BridgeInputCaptureReader& operator=(const BridgeInputCaptureReader&) = delete;
+
+    // Reads and validates the header. Returns false if the capture was made
+    // with an incompatible protocol layout.
+    bool ReadHeader() {
+        BridgeInputCaptureHeader header;
+        BridgeInputCaptureHeader expected = MakeBridgeInputCaptureHeader();
+        if (!BridgeInputCaptureReadFully(mFd, &header, sizeof(header))) {
+            return false;
+        }
+        // Newer protocols may only append event types, which the compact
+        // format lets us skip over.
+        return memcmp(header.magic, expected.magic, sizeof(header.magic)) == 0 &&
+                header.version == expected.version && header.headerSize == expected.headerSize &&
+                header.wireVersion == expected.wireVersion &&
+                header.inputEventTypeCount <= expected.inputEventTypeCount &&
+                header.eventSize == expected.eventSize &&
+                header.compactHeaderSize == expected.compactHeaderSize &&
+                header.maxCompactSize == expected.maxCompactSize;
+    }
+
+    // Returns false at the end of the capture or if it is truncated.
+    bool Next(BridgeInputEvent* outEvent) {
+        for (;;) {
+            size_t consumed =
+                    BridgeInputEvent::DecodeCompact(mBuffer + mBegin, mEnd - mBegin, outEvent);
+            if (consumed > 0) {
+                mBegin += consumed;
+                return true;
+            }
+            if (mEnd - mBegin >= BridgeInputEvent::kMaxCompactSize) {
+                return false;  // corrupt
+            }
+            memmove(mBuffer, mBuffer + mBegin, mEnd - mBegin);
+            mEnd -= mBegin;
+            mBegin = 0;
+            ssize_t n = TEMP_FAILURE_RETRY(read(mFd, mBuffer + mEnd, sizeof(mBuffer) - mEnd));
+            if (n <= 0) {
+                return false;
+            }
+            mEnd += n;
+        }
+    }
+
+private:
+    int mFd;
+    size_t mBegin = 0;
+    size_t mEnd = 0;
+    uint8_t mBuffer[64 * 1024];
+};
+
+// Re-injects a capture into a transport.
+class BridgeInputCapturePlayer {
+public:
+    enum class Mode {
+        // Sleep so that events are delivered with their original spacing.
+        REALTIME,
+        // Deliver events back to back. Useful as a consumer throughput
+        // benchmark.
+        AS_FAST_AS_POSSIBLE,
+    };
+
+    struct Options {
+        Mode mode = Mode::REALTIME;
+        // Rewrite timestamps to the CLOCK_MONOTONIC time of delivery so that
+        // the consumer's latency measurements stay meaningful.
+        bool restamp = true;
+    };
+
+    struct Result {
+        uint64_t events;
+        uint64_t elapsedNs;
+    };
+
+    // Returns false if |event| could not be delivered.
+    using Sink = std::function<bool(const BridgeInputEvent& event)>;
+
+    // Sink writing legacy-format events to a pipe such as kArcInputBridgePipe.
+    static Sink PipeSink(int fd) {
+        return [fd](const BridgeInputEvent& event) {
+            return BridgeInputCaptureWriteFully(fd, &event, sizeof(event));
+        };
+    }
+
+    // Plays the remainder of |reader| into |sink|. Stops early if the sink
+    // fails.
+    static Result Play(BridgeInputCaptureReader* reader, const Sink& sink,
+                       const Options& options) {
+        Result result{0, 0};
+        uint64_t start = BridgeInputNowNs();
+        uint64_t firstTimestamp = 0;
+        BridgeInputEvent event;
+        while (reader->Next(&event)) {
+            if (result.events == 0) {
+                firstTimestamp = event.timestamp;
+            }
+            if (options.mode == Mode::REALTIME && event.timestamp > firstTimestamp) {
+                uint64_t due = start + (event.timestamp - firstTimestamp);
+                timespec ts{static_cast<time_t>(due / 1000000000),
+                            static_cast<long>(due % 1000000000)};
+                while (clock_nanosleep(CLOCK_MONOTONIC, TIMER_ABSTIME, &ts, nullptr) == EINTR) {
+                }
+            }
+            if (options.restamp) {
+                event.timestamp = BridgeInputNowNs();
+            }
+            if (!sink(event)) {
+                break;
+            }
+            result.events++;
+        }
+        result.elapsedNs = BridgeInputNowNs() - start;
+        return result;
+    }
+};
+
+}  // namespace arc
+
+#endif  // _RUNTIME_ARC_INPUT_BRIDGE_CAPTURE_H
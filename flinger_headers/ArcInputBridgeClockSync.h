@@ -0,0 +1,217 @@
+/*
+ * Copyright 2026 The Chromium Authors.
+ *
+ * Permission is hereby granted, free of charge, to any person obtaining a
+ * copy of this software and associated documentation files (the "Software"),
+ * to deal in the Software without restriction, including without limitation
+ * the rights to use, copy, modify, merge, publish, distribute, sublicense,
+ * and/or sell copies of the Software, and to permit persons to whom the
+ * Software is furnished to do so, subject to the following conditions:
+ *
+ * The above copyright notice and this permission notice (including the next
+ * paragraph) shall be included in all copies or substantial portions of the
+ * Software.
+ *
+ * THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+ * IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+ * FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL
+ * THE AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+ * LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING
+ * FROM, OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER
+ * DEALINGS IN THE SOFTWARE.
+ */
+#ifndef _RUNTIME_ARC_INPUT_BRIDGE_CLOCK_SYNC_H
+#define _RUNTIME_ARC_INPUT_BRIDGE_CLOCK_SYNC_H
+
+#include <time.h>
+
+#include <cstddef>
+#include <cstdint>
+
+#include "ArcInputBridgeClock.h"
+#include "ArcInputBridgeProtocol.h"
+
+namespace arc {
+
+// Translation of BridgeInputEvent timestamps from the producer's clock into
+// the consumer's CLOCK_MONOTONIC.
+//
+// The producer sends a CLOCK_SYNC right after connecting and then
+// periodically (kArcInputBridgeClockSyncIntervalNs), stamped with a reading of
+// the clock it stamps all of its events with. The pipe is one-way, so the
+// consumer estimates the clock relationship from the receive times: over a
+// window of samples it takes the smallest observed delay per segment (the
+// samples least affected by scheduling) and fits a line through them, whose
+// intercept is the offset and whose slope is the drift. Translated timestamps
+// therefore include the minimum transit time of the pipe, which is a few
+// microseconds, and are never later than the time the event was received.
+//
+// Until the first CLOCK_SYNC arrives timestamps are passed through unchanged,
+// which is the behaviour of producers that predate CLOCK_SYNC.
+
+static constexpr uint64_t kArcInputBridgeClockSyncIntervalNs = 1000000000;
+
+struct BridgeInputClockStats {
+    int32_t producerClockId;
+    uint64_t samples;
+    uint64_t sequenceGaps;
+    // Consumer time minus producer time at the latest sample.
+    int64_t offsetNs;
+    // Rate at which the producer clock runs slow relative to ours, in parts
+    // per billion.
+    int64_t driftPpb;
+    // Smallest and largest receive time minus producer timestamp in the
+    // current window. Both include the offset; their difference is the
+    // transport jitter plus the drift over the window.
+    int64_t minDelayNs;
+    int64_t maxDelayNs;
+};
+
+class BridgeInputClockTranslator {
+public:
+    struct Options {
+        // If the producer stamps with the consumer's clock and both run on the
+        // same kernel, skip estimation and translate with a zero offset.
+        bool trustSameClock = false;
+    };
+
+    BridgeInputClockTranslator() = default;
+    explicit BridgeInputClockTranslator(const Options& options) : mOptions(options) {}
+
+    // Handles |event| received at |receiveNs| (consumer CLOCK_MONOTONIC, see
+    // BridgeInputNowNs()).
+    // CLOCK_SYNC events update the estimate and return false, as there is
+    // nothing to dispatch. Other events get their timestamp translated and
+    // return true.
+    bool Process(BridgeInputEvent* event, uint64_t receiveNs) {
+        if (event->type == InputEventType::CLOCK_SYNC) {
+            AddSample(*event, receiveNs);
+            return false;
+        }
+        event->timestamp = Translate(event->timestamp, receiveNs);
+        return true;
+    }
+
+    // Translates a producer timestamp of an event received at |receiveNs|.
+    uint64_t Translate(uint64_t producerNs, uint64_t receiveNs) const {
+        if (producerNs == 0) {
+            return receiveNs;
+        }
+        if (!mSynced || mIdentity) {
+            return producerNs;
+        }
+        int64_t offset = mOffset + static_cast<int64_t>(
+                (static_cast<double>(static_cast<int64_t>(producerNs - mReference))) * mSlope);
+        uint64_t translated = producerNs + offset;
+        return translated < receiveNs ? translated : receiveNs;
+    }
+
+    const BridgeInputClockStats& stats() const { return mStats; }
+
+    void Reset() {
+        mSynced = false;
+        mIdentity = false;
+        mCount = 0;
+        mStats = {};
+    }
+
+private:
+    static constexpr size_t kWindow = 128;
+    static constexpr size_t kSegments = 8;
+
+    struct Sample {
+        uint64_t producerNs;
+        int64_t delayNs;
+    };
+
+    void AddSample(const BridgeInputEvent& event, uint64_t receiveNs) {
+        const ClockSyncArgs& sync = event.clock_sync;
+        if (mSynced && sync.clockId != mStats.producerClockId) {
+            // The producer switched clocks; nothing learned so far applies.
+            Reset();
+        }
+        if (mSynced && sync.sequence != mLastSequence + 1) {
+            mStats.sequenceGaps++;
+        }
+        mLastSequence = sync.sequence;
+        mStats.producerClockId = sync.clockId;
+        mStats.samples++;
+        mSynced = true;
+        mIdentity = mOptions.trustSameClock && sync.clockId == CLOCK_MONOTONIC;
+        if (mIdentity) {
+            return;
+        }
+
+        mSamples[mCount % kWindow] = {event.timestamp,
+                                      static_cast<int64_t>(receiveNs - event.timestamp)};
+        mCount++;
+        Estimate();
+    }
+
+    // Fits a line through the minimum delay of each segment of the window.
+    void Estimate() {
+        size_t count = mCount < kWindow ? mCount : kWindow;
+        size_t first = mCount - count;
+        size_t perSegment = (count + kSegments - 1) / kSegments;
+
+        Sample points[kSegments];
+        size_t pointCount = 0;
+        int64_t maxDelay = INT64_MIN;
+        for (size_t begin = 0; begin < count; begin += perSegment) {
+            Sample best = mSamples[(first + begin) % kWindow];
+            for (size_t i = begin; i < count && i < begin + perSegment; i++) {
+                const Sample& sample = mSamples[(first + i) % kWindow];
+                if (sample.delayNs < best.delayNs) {
+                    best = sample;
+                }
+                if (sample.delayNs > maxDelay) {
+                    maxDelay = sample.delayNs;
+                }
+            }
+            points[pointCount++] = best;
+        }
+
+        // Least squares in doubles, relative to the newest sample to keep the
+        // numbers small.
+        mReference = mSamples[(mCount - 1) % kWindow].producerNs;
+        double sumX = 0, sumY = 0, sumXX = 0, sumXY = 0;
+        int64_t minDelay = INT64_MAX;
+        for (size_t i = 0; i < pointCount; i++) {
+            double x = static_cast<double>(static_cast<int64_t>(points[i].producerNs - mReference));
+            double y = static_cast<double>(points[i].delayNs);
+            sumX += x;
+            sumY += y;
+            sumXX += x * x;
+            sumXY += x * y;
+            if (points[i].delayNs < minDelay) {
+                minDelay = points[i].delayNs;
+            }
+        }
+        double n = static_cast<double>(pointCount);
+        double denominator = n * sumXX - sumX * sumX;
+        mSlope = pointCount >= 2 && denominator > 0 ? (n * sumXY - sumX * sumY) / denominator : 0;
+        mOffset = pointCount >= 2 && denominator > 0
+                ? static_cast<int64_t>((sumY - mSlope * sumX) / n)
+                : minDelay;
+
+        mStats.offsetNs = mOffset;
+        mStats.driftPpb = static_cast<int64_t>(mSlope * 1e9);
+        mStats.minDelayNs = minDelay;
+        mStats.maxDelayNs = maxDelay;
+    }
+
+    Options mOptions;
+    bool mSynced = false;
+    bool mIdentity = false;
+    uint32_t mLastSequence = 0;
+    Sample mSamples[kWindow];
+    size_t mCount = 0;
+    uint64_t mReference = 0;
+    int64_t mOffset = 0;
+    double mSlope = 0;
+    BridgeInputClockStats mStats = {};
+};
+
+}  // namespace arc
+
+#endif  // _RUNTIME_ARC_INPUT_BRIDGE_CLOCK_SYNC_H
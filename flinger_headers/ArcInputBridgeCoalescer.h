@@ -0,0 +1,177 @@
+/*
+ * Copyright 2026 The Chromium Authors.
+ *
+ * Permission is hereby granted, free of charge, to any person obtaining a
+ * copy of this software and associated documentation files (the "Software"),
+ * to deal in the Software without restriction, including without limitation
+ * the rights to use, copy, modify, merge, publish, distribute, sublicense,
+ * and/or sell copies of the Software, and to permit persons to whom the
+ * Software is furnished to do so, subject to the following conditions:
+ *
+ * The above copyright notice and this permission notice (including the next
+ * paragraph) shall be included in all copies or substantial portions of the
+ * Software.
+ *
+ * THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+ * IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+ * FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL
+ * THE AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+ * LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING
+ * FROM, OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER
+ * DEALINGS IN THE SOFTWARE.
+ */
+#ifndef _RUNTIME_ARC_INPUT_BRIDGE_COALESCER_H
+#define _RUNTIME_ARC_INPUT_BRIDGE_COALESCER_H
+
+#include <cstddef>
+#include <cstdint>
+
+#include "ArcInputBridgeProtocol.h"
+
+namespace arc {
+
+struct BridgeInputCoalescerStats {
+    uint64_t eventsIn;
+    uint64_t eventsOut;
+    uint64_t foldedPointerMoves;
+    uint64_t foldedRelativePointerMoves;
+    uint64_t foldedTouchMoves;
+    // Frame terminators dropped by BridgeInputCoalescer::Options::foldMoveOnlyFrames.
+    uint64_t foldedFrames;
+};
+
+// Optional stage that folds redundant motion events out of a run of
+// BridgeInputEvents, typically one read from the pipe after the consumer
+// fell behind.
+//
+// Consecutive POINTER_MOVE events for the same displayId keep only the newest
+// position. Consecutive TOUCH_MOVE events for the same displayId and touch id
+// keep only the newest position. Consecutive POINTER_MOVE_RELATIVE events for
+// the same displayId are summed. Any other event, including buttons, keys and
+// frame terminators, is a barrier: no move is ever folded across it.
+//
+// By default the scope of folding is a single frame. If foldMoveOnlyFrames is
+// set, a frame that contains nothing but moves is also merged into the
+// following frame when that one starts with a move, so a backlog of
+// single-move frames collapses into one frame. Frames that carry any other
+// event are never merged.
+class BridgeInputCoalescer {
+public:
+    struct Options {
+        bool foldMoveOnlyFrames = false;
+    };
+
+    BridgeInputCoalescer() = default;
+    explicit BridgeInputCoalescer(const Options& options) : mOptions(options) {}
+
+    // Coalesces |events| in place and returns the new number of events. The
+    // relative order of the remaining events is preserved.
+    size_t Coalesce(BridgeInputEvent* events, size_t count) {
+        size_t out = 0;
+        // Output index of the first event moves may be folded into.
+        size_t segmentStart = 0;
+        bool frameHasNonMove = false;
+        bool hasDeferredFrame = false;
+        BridgeInputEvent deferredFrame;
+
+        for (size_t i = 0; i < count; i++) {
+            const BridgeInputEvent& event = events[i];
+            bool move = IsMove(event.type);
+
+            if (hasDeferredFrame) {
+                hasDeferredFrame = false;
+                if (move && IsSameFamily(deferredFrame.type, event.type)) {
+                    mStats.foldedFrames++;
+                } else {
+                    events[out++] = deferredFrame;
+                    segmentStart = out;
+                }
+            }
+
+            if (!move) {
+                if (IsFrameTerminator(event.type)) {
+                    if (mOptions.foldMoveOnlyFrames && !frameHasNonMove) {
+                        deferredFrame = event;
+                        hasDeferredFrame = true;
+                        continue;
+                    }
+                    frameHasNonMove = false;
+                } else {
+                    frameHasNonMove = true;
+                }
+                events[out++] = event;
+                segmentStart = out;
+                continue;
+            }
+
+            if (!Fold(events, segmentStart, out, event)) {
+                events[out++] = event;
+            }
+        }
+        if (hasDeferredFrame) {
+            events[out++] = deferredFrame;
+        }
+
+        mStats.eventsIn += count;
+        mStats.eventsOut += out;
+        return out;
+    }
+
+    const BridgeInputCoalescerStats& stats() const { return mStats; }
+    void ResetStats() { mStats = {}; }
+
+private:
+    static bool IsMove(InputEventType type) {
+        return type == InputEventType::POINTER_MOVE ||
+                type == InputEventType::POINTER_MOVE_RELATIVE ||
+                type == InputEventType::TOUCH_MOVE;
+    }
+
+    // Whether |move| belongs to the frames terminated by |frame|.
+    static bool IsSameFamily(InputEventType frame, InputEventType move) {
+        if (frame == InputEventType::TOUCH_FRAME) {
+            return move == InputEventType::TOUCH_MOVE;
+        }
+        return frame == InputEventType::POINTER_FRAME && move != InputEventType::TOUCH_MOVE;
+    }
+
+    // Folds |event| into a matching move in events[begin, end). Returns false if
+    // there is none.
+    bool Fold(BridgeInputEvent* events, size_t begin, size_t end, const BridgeInputEvent& event) {
+        for (size_t j = begin; j < end; j++) {
+            BridgeInputEvent& target = events[j];
+            if (target.type != event.type || target.displayId != event.displayId) {
+                continue;
+            }
+            switch (event.type) {
+                case InputEventType::POINTER_MOVE:
+                    target = event;
+                    mStats.foldedPointerMoves++;
+                    return true;
+                case InputEventType::POINTER_MOVE_RELATIVE:
+                    target.timestamp = event.timestamp;
+                    target.relativePointer.dx += event.relativePointer.dx;
+                    target.relativePointer.dy += event.relativePointer.dy;
+                    mStats.foldedRelativePointerMoves++;
+                    return true;
+                case InputEventType::TOUCH_MOVE:
+                    if (target.touch.id != event.touch.id) {
+                        continue;
+                    }
+                    target = event;
+                    mStats.foldedTouchMoves++;
+                    return true;
+                default:
+                    return false;
+            }
+        }
+        return false;
+    }
+
+    Options mOptions;
+    BridgeInputCoalescerStats mStats = {};
+};
+
+}  // namespace arc
+
+#endif  // _RUNTIME_ARC_INPUT_BRIDGE_COALESCER_H
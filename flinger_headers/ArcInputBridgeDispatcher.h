@@ -0,0 +1,146 @@
+/*
+ * Copyright 2026 The Chromium Authors.
+ *
+ * Permission is hereby granted, free of charge, to any person obtaining a
+ * copy of this software and associated documentation files (the "Software"),
+ * to deal in the Software without restriction, including without limitation
+ * the rights to use, copy, modify, merge, publish, distribute, sublicense,
+ * and/or sell copies of the Software, and to permit persons to whom the
+ * Software is furnished to do so, subject to the following conditions:
+ *
+ * The above copyright notice and this permission notice (including the next
+ * paragraph) shall be included in all copies or substantial portions of the
+ * Software.
+ *
+ * THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+ * IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+ * FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL
+ * THE AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+ * LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING
+ * FROM, OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER
+ * DEALINGS IN THE SOFTWARE.
+ */
+#ifndef _RUNTIME_ARC_INPUT_BRIDGE_DISPATCHER_H
+#define _RUNTIME_ARC_INPUT_BRIDGE_DISPATCHER_H
+
+#include <array>
+#include <cstddef>
+#include <cstring>
+#include <type_traits>
+#include <utility>
+
+#include "ArcInputBridgeProtocol.h"
+
+namespace arc {
+
+// Maps an InputEventType to the member of BridgeInputEvent's union it uses.
+// Types without a specialization can't be dispatched.
+template <InputEventType Type>
+struct InputEventArgs {
+    using type = void;
+};
+
+#define ARC_INPUT_EVENT_ARGS(eventType, argsType, member) \
+    template <>                                          \
+    struct InputEventArgs<InputEventType::eventType> {   \
+        using type = argsType;                           \
+    };
+
+ARC_INPUT_BRIDGE_EVENT_TYPES(ARC_INPUT_EVENT_ARGS)
+
+#undef ARC_INPUT_EVENT_ARGS
+
+// Tag passed to handlers so overloads can be selected per event type.
+template <InputEventType Type>
+using InputEventTag = std::integral_constant<InputEventType, Type>;
+
+// Calls the overload of |Handler| matching the type of each event, passing
+// the args struct that type uses:
+//
+//   struct Handler {
+//       void operator()(InputEventTag<InputEventType::KEY>,
+//                       const BridgeInputEvent& event, const KeyArgs& key);
+//       void operator()(InputEventTag<InputEventType::TOUCH_MOVE>,
+//                       const BridgeInputEvent& event, const TouchArgs& touch);
+//   };
+//
+// A generic lambda or templated operator() handles every type. Whether a type
+// is handled is decided at compile time, and dispatching is a single indexed
+// load from a table of kInputEventTypeCount function pointers. Events of
+// unhandled or unknown types are skipped.
+template <typename Handler>
+class BridgeInputEventDispatcher {
+public:
+    explicit BridgeInputEventDispatcher(Handler& handler) : mHandler(handler) {}
+
+    // Returns true if the event was handled.
+    bool Dispatch(const BridgeInputEvent& event) const {
+        size_t index = static_cast<size_t>(event.type);
+        if (index >= kInputEventTypeCount || kTable[index] == nullptr) {
+            return false;
+        }
+        kTable[index](mHandler, event);
+        return true;
+    }
+
+    template <InputEventType Type>
+    static constexpr bool Handles() {
+        using Args = typename InputEventArgs<Type>::type;
+        if constexpr (std::is_void_v<Args>) {
+            return false;
+        } else {
+            return std::is_invocable_v<Handler&, InputEventTag<Type>, const BridgeInputEvent&,
+                                       const Args&>;
+        }
+    }
+
+private:
+    using Entry = void (*)(Handler&, const BridgeInputEvent&);
+
+    template <InputEventType Type>
+    static void Invoke(Handler& handler, const BridgeInputEvent& event) {
+        using Args = typename InputEventArgs<Type>::type;
+        const uint8_t* data = reinterpret_cast<const uint8_t*>(&event) + kArgsOffset;
+        if constexpr (alignof(Args) == 1) {
+            handler(InputEventTag<Type>{}, event, *reinterpret_cast<const Args*>(data));
+        } else {
+            // The args live at an unaligned offset inside the packed event, so
+            // copy them out rather than hand out a misaligned reference.
+            Args args;
+            memcpy(&args, data, sizeof(args));
+            handler(InputEventTag<Type>{}, event, args);
+        }
+    }
+
+    template <size_t Index>
+    static constexpr Entry MakeEntry() {
+        constexpr InputEventType type = static_cast<InputEventType>(Index);
+        if constexpr (Handles<type>()) {
+            return &Invoke<type>;
+        } else {
+            return nullptr;
+        }
+    }
+
+    template <size_t... Indices>
+    static constexpr std::array<Entry, kInputEventTypeCount> MakeTable(
+            std::index_sequence<Indices...>) {
+        return {{MakeEntry<Indices>()...}};
+    }
+
+    static constexpr size_t kArgsOffset = offsetof(BridgeInputEvent, pointer);
+    static constexpr std::array<Entry, kInputEventTypeCount> kTable =
+            MakeTable(std::make_index_sequence<kInputEventTypeCount>());
+
+    Handler& mHandler;
+};
+
+// Convenience wrapper for one-off dispatching.
+template <typename Handler>
+bool DispatchBridgeInputEvent(const BridgeInputEvent& event, Handler& handler) {
+    return BridgeInputEventDispatcher<Handler>(handler).Dispatch(event);
+}
+
+}  // namespace arc
+
+#endif  // _RUNTIME_ARC_INPUT_BRIDGE_DISPATCHER_H
@@ -0,0 +1,322 @@
+/*
+ * Copyright 2026 The Chromium Authors.
+ *
+ * Permission is hereby granted, free of charge, to any person obtaining a
+ * copy of this software and associated documentation files (the "Software"),
+ * to deal in the Software without restriction, including without limitation
+ * the rights to use, copy, modify, merge, publish, distribute, sublicense,
+ * and/or sell copies of the Software, and to permit persons to whom the
+ * Software is furnished to do so, subject to the following conditions:
+ *
+ * The above copyright notice and this permission notice (including the next
+ * paragraph) shall be included in all copies or substantial portions of the
+ * Software.
+ *
+ * THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+ * IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+ * FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL
+ * THE AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+ * LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING
+ * FROM, OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER
+ * DEALINGS IN THE SOFTWARE.
+ */
+#ifndef _RUNTIME_ARC_INPUT_BRIDGE_DISPLAY_DEMUX_H
+#define _RUNTIME_ARC_INPUT_BRIDGE_DISPLAY_DEMUX_H
+
+#include <sys/eventfd.h>
+#include <unistd.h>
+
+#include <atomic>
+#include <cstddef>
+#include <cstdint>
+#include <deque>
+#include <memory>
+#include <mutex>
+#include <shared_mutex>
+#include <vector>
+
+#include "ArcInputBridgeProtocol.h"
+
+namespace arc {
+
+// Default maximum number of queues a BridgeInputDisplayDemux creates, counting
+// the one for events without a display.
+static constexpr size_t kArcInputBridgeMaxDisplayQueues = 16;
+
+// Default maximum number of events a display queue holds. This is a couple of
+// seconds of touch input at 120 Hz with ten contacts.
+static constexpr size_t kArcInputBridgeMaxDisplayQueueEvents = 4096;
+
+// Per-display queue of events. Each queue has its own eventfd, which becomes
+// readable when an event is pushed into the empty queue, so a consumer can
+// wait on a single display without being woken up by the others.
+//
+// The queue holds at most |maxEvents| events. An event that would overflow it
+// is dropped together with everything still queued, and replaced by RESET and
+// KEY_RESET, the way evdev replaces its buffer with SYN_DROPPED: the consumer
+// starts over from the events that follow instead of acting on a stream with
+// a hole in it. Dropped events are counted in droppedEvents().
+class BridgeInputDisplayQueue {
+public:
+    explicit BridgeInputDisplayQueue(int32_t displayId,
+                                     size_t maxEvents = kArcInputBridgeMaxDisplayQueueEvents)
+          : mDisplayId(displayId),
+            mMaxEvents(maxEvents > 2 ? maxEvents : 2),
+            mEventFd(eventfd(0, EFD_CLOEXEC | EFD_NONBLOCK)) {}
+    ~BridgeInputDisplayQueue() {
+        if (mEventFd >= 0) {
+            close(mEventFd);
+        }
+    }
+
+    BridgeInputDisplayQueue(const BridgeInputDisplayQueue&) = delete;
+    BridgeInputDisplayQueue& operator=(const BridgeInputDisplayQueue&) = delete;
+
+    int32_t displayId() const { return mDisplayId; }
+    int eventFd() const { return mEventFd; }
+
+    // Returns true if the queue was empty.
+    bool Push(const BridgeInputEvent& event) {
+        bool wasEmpty;
+        {
+            std::lock_guard<std::mutex> lock(mLock);
+            wasEmpty = mEvents.empty();
+            if (mEvents.size() < mMaxEvents) {
+                mEvents.push_back(event);
+            } else {
+                mDroppedEvents += mEvents.size() + 1;
+                mEvents.clear();
+                BridgeInputEvent reset = BridgeInputEvent::ResetEvent(event.timestamp);
+                reset.displayId = mDisplayId;
+                mEvents.push_back(reset);
+                reset.type = InputEventType::KEY_RESET;
+                mEvents.push_back(reset);
+            }
+        }
+        if (wasEmpty) {
+            uint64_t one = 1;
+            TEMP_FAILURE_RETRY(write(mEventFd, &one, sizeof(one)));
+        }
+        return wasEmpty;
+    }
+
+    // Pops up to |max| events into |out|, oldest first, and returns how many.
+    // Clears the eventfd once the queue is drained.
+    size_t Pop(BridgeInputEvent* out, size_t max) {
+        std::lock_guard<std::mutex> lock(mLock);
+        size_t count = mEvents.size() < max ? mEvents.size() : max;
+        for (size_t i = 0; i < count; i++) {
+            out[i] = mEvents.front();
+            mEvents.pop_front();
+        }
+        if (mEvents.empty()) {
+            uint64_t value;
+            TEMP_FAILURE_RETRY(read(mEventFd, &value, sizeof(value)));
+        }
+        return count;
+    }
+
+    size_t size() const {
+        std::lock_guard<std::mutex> lock(mLock);
+        return mEvents.size();
+    }
+
+    // Number of events dropped because the queue was full.
+    uint64_t droppedEvents() const {
+        std::lock_guard<std::mutex> lock(mLock);
+        return mDroppedEvents;
+    }
+
+private:
+    const int32_t mDisplayId;
+    const size_t mMaxEvents;
+    const int mEventFd;
+    mutable std::mutex mLock;
+    std::deque<BridgeInputEvent> mEvents;
+    uint64_t mDroppedEvents = 0;
+};
+
+// Demultiplexes a single BridgeInputEvent stream into per-display queues, so
+// that a burst on one display doesn't delay events for another. Ordering is
+// preserved within a display but not across displays. Events that don't
+// target a display (displayId -1, e.g. keys) get a queue of their own.
+//
+// Push() takes decoded events. Read the pipe through BridgeInputStreamDecoder
+// or one of the readers built on it rather than in sizeof(BridgeInputEvent)
+// chunks, so that the stream keeps decoding after a WIRE_FORMAT switch.
+//
+// RESET and KEY_RESET are pushed into every queue, so each display sees them
+// after the events that preceded them in the stream and before the ones that
+// followed. A PopFair consumer therefore gets one copy per display; resetting
+// is idempotent, so it can act on each of them or skip the repeats.
+//
+// Each queue is bounded, see BridgeInputDisplayQueue; a consumer that falls
+// behind on one display loses that display's backlog, not the others'.
+//
+// Display ids come from the peer, so the number of queues is capped. Events
+// for a display beyond the cap, or with an id below -1, are dropped and
+// counted in rejectedEvents().
+//
+// Consumers can either run a thread per display and use Pop/eventFd, or drain
+// every display from one thread with PopFair, which serves the displays
+// round-robin with a fixed quantum so no display can starve the others.
+class BridgeInputDisplayDemux {
+public:
+    // |quantum| is the maximum number of events PopFair takes from one display
+    // before moving on to the next. |maxQueues| caps the number of displays
+    // and |maxQueueEvents| the number of events queued for each of them.
+    explicit BridgeInputDisplayDemux(size_t quantum = 8,
+                                     size_t maxQueues = kArcInputBridgeMaxDisplayQueues,
+                                     size_t maxQueueEvents = kArcInputBridgeMaxDisplayQueueEvents)
+          : mQuantum(quantum > 0 ? quantum : 1),
+            mMaxQueues(maxQueues > 0 ? maxQueues : 1),
+            mMaxQueueEvents(maxQueueEvents),
+            mEventFd(eventfd(0, EFD_CLOEXEC | EFD_NONBLOCK)) {}
+    ~BridgeInputDisplayDemux() {
+        if (mEventFd >= 0) {
+            close(mEventFd);
+        }
+    }
+
+    BridgeInputDisplayDemux(const BridgeInputDisplayDemux&) = delete;
+    BridgeInputDisplayDemux& operator=(const BridgeInputDisplayDemux&) = delete;
+
+    // Routes |event| to the queue of its display, creating it if needed.
+    // Returns false if the event was rejected.
+    bool Push(const BridgeInputEvent& event) {
+        if (event.type == InputEventType::RESET || event.type == InputEventType::KEY_RESET) {
+            Broadcast(event);
+            return true;
+        }
+        BridgeInputDisplayQueue* queue = GetOrCreateQueue(event.displayId);
+        if (queue == nullptr) {
+            mRejectedEvents.fetch_add(1, std::memory_order_relaxed);
+            return false;
+        }
+        if (queue->Push(event)) {
+            Notify();
+        }
+        return true;
+    }
+
+    // Number of events dropped because their display id was invalid or over
+    // the cap.
+    uint64_t rejectedEvents() const { return mRejectedEvents.load(std::memory_order_relaxed); }
+
+    // Number of events dropped because their display's queue was full.
+    uint64_t droppedEvents() {
+        std::shared_lock<std::shared_mutex> lock(mQueuesLock);
+        uint64_t dropped = 0;
+        for (const auto& queue : mQueues) {
+            dropped += queue->droppedEvents();
+        }
+        return dropped;
+    }
+
+    // Readable when any display queue goes from empty to non-empty. Use with
+    // PopFair.
+    int eventFd() const { return mEventFd; }
+
+    // Returns the eventfd of |displayId|'s queue, or -1 if the display can't
+    // have one.
+    int eventFd(int32_t displayId) {
+        BridgeInputDisplayQueue* queue = GetOrCreateQueue(displayId);
+        return queue != nullptr ? queue->eventFd() : -1;
+    }
+
+    // Pops up to |max| events of |displayId| into |out|.
+    size_t Pop(int32_t displayId, BridgeInputEvent* out, size_t max) {
+        BridgeInputDisplayQueue* queue = GetOrCreateQueue(displayId);
+        return queue != nullptr ? queue->Pop(out, max) : 0;
+    }
+
+    // Pops up to |max| events from all displays into |out|, taking at most one
+    // quantum from each display in turn. The display served first rotates
+    // between calls. Only call this from a single thread.
+    size_t PopFair(BridgeInputEvent* out, size_t max) {
+        uint64_t value;
+        TEMP_FAILURE_RETRY(read(mEventFd, &value, sizeof(value)));
+
+        std::shared_lock<std::shared_mutex> lock(mQueuesLock);
+        size_t queues = mQueues.size();
+        size_t count = 0;
+        size_t idleQueues = 0;
+        while (count < max && idleQueues < queues) {
+            BridgeInputDisplayQueue& queue = *mQueues[mNext % queues];
+            mNext = (mNext + 1) % queues;
+            size_t want = max - count < mQuantum ? max - count : mQuantum;
+            size_t got = queue.Pop(out + count, want);
+            count += got;
+            // A full round in which no display had anything means we're done.
+            idleQueues = got == 0 ? idleQueues + 1 : 0;
+        }
+        if (count == max) {
+            // Events may be left; make sure the caller comes back for them.
+            uint64_t one = 1;
+            TEMP_FAILURE_RETRY(write(mEventFd, &one, sizeof(one)));
+        }
+        return count;
+    }
+
+private:
+    void Notify() {
+        uint64_t one = 1;
+        TEMP_FAILURE_RETRY(write(mEventFd, &one, sizeof(one)));
+    }
+
+    void Broadcast(const BridgeInputEvent& event) {
+        // Make sure there is at least one queue to carry it.
+        GetOrCreateQueue(-1);
+        bool wokeAny = false;
+        {
+            std::shared_lock<std::shared_mutex> lock(mQueuesLock);
+            for (const auto& queue : mQueues) {
+                wokeAny |= queue->Push(event);
+            }
+        }
+        if (wokeAny) {
+            Notify();
+        }
+    }
+
+    // Returns nullptr if |displayId| is invalid or the cap is reached.
+    BridgeInputDisplayQueue* GetOrCreateQueue(int32_t displayId) {
+        if (displayId < -1) {
+            return nullptr;
+        }
+        {
+            std::shared_lock<std::shared_mutex> lock(mQueuesLock);
+            for (const auto& queue : mQueues) {
+                if (queue->displayId() == displayId) {
+                    return queue.get();
+                }
+            }
+        }
+        std::unique_lock<std::shared_mutex> lock(mQueuesLock);
+        for (const auto& queue : mQueues) {
+            if (queue->displayId() == displayId) {
+                return queue.get();
+            }
+        }
+        if (mQueues.size() >= mMaxQueues) {
+            return nullptr;
+        }
+        mQueues.push_back(std::make_unique<BridgeInputDisplayQueue>(displayId, mMaxQueueEvents));
+        return mQueues.back().get();
+    }
+
+    const size_t mQuantum;
+    const size_t mMaxQueues;
+    const size_t mMaxQueueEvents;
+    const int mEventFd;
+    std::atomic<uint64_t> mRejectedEvents{0};
+    size_t mNext = 0;
+    // Displays are few and rarely added, so a vector under a reader/writer
+    // lock keeps the common lookup cheap.
+    std::shared_mutex mQueuesLock;
+    std::vector<std::unique_ptr<BridgeInputDisplayQueue>> mQueues;
+};
+
+}  // namespace arc
+
+#endif  // _RUNTIME_ARC_INPUT_BRIDGE_DISPLAY_DEMUX_H
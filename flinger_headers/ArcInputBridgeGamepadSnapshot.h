@@ -0,0 +1,235 @@
+/*
+ * Copyright 2026 The Chromium Authors.
+ *
+ * Permission is hereby granted, free of charge, to any person obtaining a
+ * copy of this software and associated documentation files (the "Software"),
+ * to deal in the Software without restriction, including without limitation
+ * the rights to use, copy, modify, merge, publish, distribute, sublicense,
+ * and/or sell copies of the Software, and to permit persons to whom the
+ * Software is furnished to do so, subject to the following conditions:
+ *
+ * The above copyright notice and this permission notice (including the next
+ * paragraph) shall be included in all copies or substantial portions of the
+ * Software.
+ *
+ * THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+ * IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+ * FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL
+ * THE AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+ * LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING
+ * FROM, OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER
+ * DEALINGS IN THE SOFTWARE.
+ */
+#ifndef _RUNTIME_ARC_INPUT_BRIDGE_GAMEPAD_SNAPSHOT_H
+#define _RUNTIME_ARC_INPUT_BRIDGE_GAMEPAD_SNAPSHOT_H
+
+#include <cstddef>
+#include <cstdint>
+#include <vector>
+
+#include "ArcInputBridgeProtocol.h"
+
+namespace arc {
+
+// Producer side: folds the GAMEPAD_AXIS and GAMEPAD_BUTTON events of a frame
+// into one GAMEPAD_SNAPSHOT, which replaces the frame's GAMEPAD_FRAME.
+//
+// An axis or button that changes more than once in a frame only keeps its
+// latest value. Axes and buttons outside the snapshot bitmasks are passed
+// through unchanged. Any other event flushes the pending snapshots first (as
+// snapshots that don't end a frame), so it keeps its place relative to the
+// gamepad events around it.
+//
+// Order between gamepads is only kept per gamepad: a GAMEPAD_FRAME flushes
+// the snapshot of its own gamepad, so changes still pending for another one
+// come out after it even if they were read before it. Consumers apply each
+// gamepad's frames on their own, so nothing depends on the order across
+// gamepads.
+class BridgeInputGamepadSnapshotAccumulator {
+public:
+    // Feeds |event| and appends the events to send, if any, to |out|.
+    void Add(const BridgeInputEvent& event, std::vector<BridgeInputEvent>* out) {
+        switch (event.type) {
+            case InputEventType::GAMEPAD_AXIS:
+                if (event.gamepad.axis >= 0 && event.gamepad.axis < kGamepadSnapshotAxisCount) {
+                    AddAxis(event, out);
+                    return;
+                }
+                break;
+            case InputEventType::GAMEPAD_BUTTON:
+                if (event.gamepad.button >= 0 &&
+                    event.gamepad.button < kGamepadSnapshotButtonCount) {
+                    AddButton(event, out);
+                    return;
+                }
+                break;
+            case InputEventType::GAMEPAD_FRAME: {
+                Pending* pending = Find(event.gamepad.id);
+                if (pending != nullptr) {
+                    pending->timestamp = event.timestamp;
+                    Flush(pending, true, out);
+                    Remove(pending);
+                    return;
+                }
+                break;
+            }
+            default:
+                break;
+        }
+        FlushAll(out);
+        out->push_back(event);
+    }
+
+    // Sends everything pending as snapshots that don't end a frame.
+    void FlushAll(std::vector<BridgeInputEvent>* out) {
+        for (Pending& pending : mPending) {
+            Flush(&pending, false, out);
+        }
+        mPending.clear();
+    }
+
+private:
+    struct Pending {
+        int32_t id;
+        int32_t displayId;
+        uint64_t timestamp;
+        uint64_t changedAxes;
+        uint32_t changedButtons;
+        uint32_t pressedButtons;
+        float axes[kGamepadSnapshotAxisCount];
+        float buttons[kGamepadSnapshotButtonCount];
+    };
+
+    void AddAxis(const BridgeInputEvent& event, std::vector<BridgeInputEvent>* out) {
+        Pending* pending = Prepare(event, out);
+        uint64_t bit = uint64_t{1} << event.gamepad.axis;
+        if (!(pending->changedAxes & bit) && IsFull(*pending)) {
+            Flush(pending, false, out);
+        }
+        pending->changedAxes |= bit;
+        pending->axes[event.gamepad.axis] = event.gamepad.value;
+    }
+
+    void AddButton(const BridgeInputEvent& event, std::vector<BridgeInputEvent>* out) {
+        Pending* pending = Prepare(event, out);
+        uint32_t bit = uint32_t{1} << event.gamepad.button;
+        if (!(pending->changedButtons & bit) && IsFull(*pending)) {
+            Flush(pending, false, out);
+        }
+        pending->changedButtons |= bit;
+        if (event.gamepad.pressed) {
+            pending->pressedButtons |= bit;
+        } else {
+            pending->pressedButtons &= ~bit;
+        }
+        pending->buttons[event.gamepad.button] = event.gamepad.value;
+    }
+
+    // Returns the pending snapshot for the event's gamepad, creating it if
+    // needed.
+    Pending* Prepare(const BridgeInputEvent& event, std::vector<BridgeInputEvent>* out) {
+        Pending* pending = Find(event.gamepad.id);
+        if (pending != nullptr && pending->displayId != event.displayId) {
+            Flush(pending, false, out);
+        }
+        if (pending == nullptr) {
+            mPending.push_back({});
+            pending = &mPending.back();
+            pending->id = event.gamepad.id;
+        }
+        pending->displayId = event.displayId;
+        pending->timestamp = event.timestamp;
+        return pending;
+    }
+
+    Pending* Find(int32_t id) {
+        for (Pending& pending : mPending) {
+            if (pending.id == id) {
+                return &pending;
+            }
+        }
+        return nullptr;
+    }
+
+    void Remove(Pending* pending) {
+        mPending.erase(mPending.begin() + (pending - mPending.data()));
+    }
+
+    static bool IsFull(const Pending& pending) {
+        return static_cast<uint32_t>(__builtin_popcountll(pending.changedAxes) +
+                                     __builtin_popcount(pending.changedButtons)) >=
+                kGamepadSnapshotMaxValues;
+    }
+
+    // Appends |pending| as a snapshot to |out| and clears it. Without changes
+    // only the frame end, if any, is sent.
+    static void Flush(Pending* pending, bool endsFrame, std::vector<BridgeInputEvent>* out) {
+        if (pending->changedAxes == 0 && pending->changedButtons == 0) {
+            if (endsFrame) {
+                BridgeInputEvent frame =
+                        BridgeInputEvent::GamepadFrameEvent(pending->timestamp, pending->id);
+                frame.displayId = pending->displayId;
+                out->push_back(frame);
+            }
+            return;
+        }
+        BridgeInputEvent event =
+                BridgeInputEvent::GamepadSnapshotEvent(pending->timestamp, pending->id);
+        event.displayId = pending->displayId;
+        GamepadSnapshotArgs& snapshot = event.gamepad_snapshot;
+        snapshot.changedAxes = pending->changedAxes;
+        snapshot.changedButtons = pending->changedButtons;
+        snapshot.pressedButtons = pending->pressedButtons & pending->changedButtons;
+        snapshot.endsFrame = endsFrame;
+        uint32_t count = 0;
+        for (uint64_t bits = pending->changedAxes; bits != 0; bits &= bits - 1) {
+            snapshot.values[count++] = pending->axes[__builtin_ctzll(bits)];
+        }
+        for (uint32_t bits = pending->changedButtons; bits != 0; bits &= bits - 1) {
+            snapshot.values[count++] = pending->buttons[__builtin_ctz(bits)];
+        }
+        out->push_back(event);
+        pending->changedAxes = 0;
+        pending->changedButtons = 0;
+        pending->pressedButtons = 0;
+    }
+
+    // Usually a single gamepad.
+    std::vector<Pending> mPending;
+};
+
+// Consumer side: expands a GAMEPAD_SNAPSHOT back into the GAMEPAD_AXIS,
+// GAMEPAD_BUTTON and GAMEPAD_FRAME events it replaced, for consumers that
+// only understand per-axis events. Axes come before buttons; the order of
+// changes within a frame isn't preserved, which is fine since the frame is
+// applied as a whole.
+static inline void ExpandGamepadSnapshot(const BridgeInputEvent& event,
+                                         std::vector<BridgeInputEvent>* out) {
+    const GamepadSnapshotArgs& snapshot = event.gamepad_snapshot;
+    uint32_t count = 0;
+    for (uint64_t bits = snapshot.changedAxes;
+         bits != 0 && count < kGamepadSnapshotMaxValues; bits &= bits - 1) {
+        BridgeInputEvent axis = BridgeInputEvent::GamepadAxisEvent(
+                event.timestamp, snapshot.id, __builtin_ctzll(bits), snapshot.values[count++]);
+        axis.displayId = event.displayId;
+        out->push_back(axis);
+    }
+    for (uint32_t bits = snapshot.changedButtons;
+         bits != 0 && count < kGamepadSnapshotMaxValues; bits &= bits - 1) {
+        int32_t index = __builtin_ctz(bits);
+        BridgeInputEvent button = BridgeInputEvent::GamepadButtonEvent(
+                event.timestamp, snapshot.id, index, (snapshot.pressedButtons >> index) & 1,
+                snapshot.values[count++]);
+        button.displayId = event.displayId;
+        out->push_back(button);
+    }
+    if (snapshot.endsFrame) {
+        BridgeInputEvent frame = BridgeInputEvent::GamepadFrameEvent(event.timestamp, snapshot.id);
+        frame.displayId = event.displayId;
+        out->push_back(frame);
+    }
+}
+
+}  // namespace arc
+
+#endif  // _RUNTIME_ARC_INPUT_BRIDGE_GAMEPAD_SNAPSHOT_H
@@ -0,0 +1,213 @@
+/*
+ * Copyright 2026 The Chromium Authors.
+ *
+ * Permission is hereby granted, free of charge, to any person obtaining a
+ * copy of this software and associated documentation files (the "Software"),
+ * to deal in the Software without restriction, including without limitation
+ * the rights to use, copy, modify, merge, publish, distribute, sublicense,
+ * and/or sell copies of the Software, and to permit persons to whom the
+ * Software is furnished to do so, subject to the following conditions:
+ *
+ * The above copyright notice and this permission notice (including the next
+ * paragraph) shall be included in all copies or substantial portions of the
+ * Software.
+ *
+ * THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+ * IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+ * FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL
+ * THE AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+ * LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING
+ * FROM, OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER
+ * DEALINGS IN THE SOFTWARE.
+ */
+#ifndef _RUNTIME_ARC_INPUT_BRIDGE_KEY_STATE_H
+#define _RUNTIME_ARC_INPUT_BRIDGE_KEY_STATE_H
+
+#include <cstddef>
+#include <cstdint>
+
+#include "ArcInputBridgeProtocol.h"
+
+namespace arc {
+
+// One past the highest Linux scan code (KEY_MAX).
+static constexpr uint32_t kArcInputBridgeScanCodeCount = 0x300;
+
+struct BridgeInputKeyStateStats {
+    uint64_t presses;
+    uint64_t releases;
+    // Presses of a key that was already down.
+    uint64_t repeatedPresses;
+    // Releases of a key that wasn't down, e.g. one pressed before a reset.
+    uint64_t orphanReleases;
+    // Scan codes at or above kArcInputBridgeScanCodeCount. They are ignored.
+    uint64_t invalidScanCodes;
+    // KEY events whose serial didn't follow the previous one.
+    uint64_t serialGaps;
+    uint64_t resets;
+};
+
+// Consumer side tracker of the keyboard state carried by KEY, KEY_MODIFIERS
+// and KEY_RESET, so that the Android side doesn't rebuild it per event.
+//
+// Pressed keys are a bitset indexed by scan code. Each 64-bit word carries the
+// generation it was last written in, and a word from an older generation reads
+// as all released, so KEY_RESET (or RESET) is O(1) regardless of how many keys
+// were down. Every query is O(1) too.
+//
+// Wayland serials come from a counter the compositor shares between all
+// events, so by default only serials that fail to increase (wrapping around)
+// count as gaps. Set Options::contiguousSerials when the producer numbers key
+// events on their own and any skipped serial means a lost event.
+//
+// The most recently pressed key that is still down is remembered as the
+// repeat candidate, which is the key Android would auto-repeat.
+class BridgeInputKeyStateTracker {
+public:
+    struct Options {
+        bool contiguousSerials = false;
+    };
+
+    BridgeInputKeyStateTracker() : BridgeInputKeyStateTracker(Options()) {}
+    explicit BridgeInputKeyStateTracker(const Options& options) : mOptions(options) {}
+
+    // Feeds |event|. Returns true if it changed the pressed keys or meta
+    // state. Events other than KEY, KEY_MODIFIERS, KEY_RESET and RESET are
+    // ignored.
+    bool Add(const BridgeInputEvent& event) {
+        switch (event.type) {
+            case InputEventType::KEY:
+                CheckSerial(event.key.serial);
+                return SetPressed(event.key.scanCode, event.key.state != 0, event.timestamp);
+            case InputEventType::KEY_MODIFIERS: {
+                bool changed = mMetaState != event.meta.metaState;
+                mMetaState = event.meta.metaState;
+                return changed;
+            }
+            case InputEventType::KEY_RESET:
+            case InputEventType::RESET: {
+                bool changed = mPressedCount != 0 || mMetaState != 0;
+                Reset();
+                return changed;
+            }
+            default:
+                return false;
+        }
+    }
+
+    // Releases every key and clears the meta state in O(1).
+    void Reset() {
+        if (++mGeneration == 0) {
+            // Wrapped around; stale words could alias the new generation.
+            for (Word& word : mWords) {
+                word = Word();
+            }
+            mGeneration = 1;
+        }
+        mPressedCount = 0;
+        mMetaState = 0;
+        mRepeatScanCode = kNoKey;
+        mHasSerial = false;
+        mStats.resets++;
+    }
+
+    bool IsPressed(uint32_t scanCode) const {
+        if (scanCode >= kArcInputBridgeScanCodeCount) {
+            return false;
+        }
+        const Word& word = mWords[scanCode / 64];
+        return word.generation == mGeneration && (word.bits >> (scanCode % 64)) & 1;
+    }
+
+    bool AnyPressed() const { return mPressedCount != 0; }
+    uint32_t pressedCount() const { return mPressedCount; }
+
+    // Android AMETA_ bitmask from the last KEY_MODIFIERS.
+    uint32_t metaState() const { return mMetaState; }
+
+    // Returns true and the scan code and press time of the most recently
+    // pressed key if it is still down.
+    bool GetRepeatKey(uint32_t* outScanCode, uint64_t* outDownTime) const {
+        if (mRepeatScanCode == kNoKey) {
+            return false;
+        }
+        *outScanCode = mRepeatScanCode;
+        *outDownTime = mRepeatDownTime;
+        return true;
+    }
+
+    const BridgeInputKeyStateStats& stats() const { return mStats; }
+
+private:
+    static constexpr uint32_t kNoKey = UINT32_MAX;
+    static constexpr size_t kWordCount = kArcInputBridgeScanCodeCount / 64;
+
+    struct Word {
+        uint64_t bits = 0;
+        uint32_t generation = 0;
+    };
+
+    void CheckSerial(uint32_t serial) {
+        if (mHasSerial) {
+            int32_t delta = static_cast<int32_t>(serial - mLastSerial);
+            if (mOptions.contiguousSerials ? delta != 1 : delta <= 0) {
+                mStats.serialGaps++;
+            }
+        }
+        mLastSerial = serial;
+        mHasSerial = true;
+    }
+
+    bool SetPressed(uint32_t scanCode, bool pressed, uint64_t timestamp) {
+        if (scanCode >= kArcInputBridgeScanCodeCount) {
+            mStats.invalidScanCodes++;
+            return false;
+        }
+        Word& word = mWords[scanCode / 64];
+        if (word.generation != mGeneration) {
+            word.bits = 0;
+            word.generation = mGeneration;
+        }
+        uint64_t bit = uint64_t{1} << (scanCode % 64);
+        bool wasPressed = word.bits & bit;
+        if (pressed) {
+            mStats.presses++;
+            if (wasPressed) {
+                mStats.repeatedPresses++;
+                return false;
+            }
+            mRepeatScanCode = scanCode;
+            mRepeatDownTime = timestamp;
+            word.bits |= bit;
+            mPressedCount++;
+            return true;
+        }
+        mStats.releases++;
+        if (mRepeatScanCode == scanCode) {
+            mRepeatScanCode = kNoKey;
+        }
+        if (!wasPressed) {
+            mStats.orphanReleases++;
+            return false;
+        }
+        word.bits &= ~bit;
+        mPressedCount--;
+        return true;
+    }
+
+    Options mOptions;
+    // Starts at 1 so that the zero-initialized words read as stale.
+    uint32_t mGeneration = 1;
+    uint32_t mPressedCount = 0;
+    uint32_t mMetaState = 0;
+    uint32_t mRepeatScanCode = kNoKey;
+    uint64_t mRepeatDownTime = 0;
+    uint32_t mLastSerial = 0;
+    bool mHasSerial = false;
+    Word mWords[kWordCount];
+    BridgeInputKeyStateStats mStats = {};
+};
+
+}  // namespace arc
+
+#endif  // _RUNTIME_ARC_INPUT_BRIDGE_KEY_STATE_H
@@ -0,0 +1,226 @@
+/*
+ * Copyright 2026 The Chromium Authors.
+ *
+ * Permission is hereby granted, free of charge, to any person obtaining a
+ * copy of this software and associated documentation files (the "Software"),
+ * to deal in the Software without restriction, including without limitation
+ * the rights to use, copy, modify, merge, publish, distribute, sublicense,
+ * and/or sell copies of the Software, and to permit persons to whom the
+ * Software is furnished to do so, subject to the following conditions:
+ *
+ * The above copyright notice and this permission notice (including the next
+ * paragraph) shall be included in all copies or substantial portions of the
+ * Software.
+ *
+ * THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+ * IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+ * FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL
+ * THE AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+ * LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING
+ * FROM, OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER
+ * DEALINGS IN THE SOFTWARE.
+ */
+#ifndef _RUNTIME_ARC_INPUT_BRIDGE_LATENCY_H
+#define _RUNTIME_ARC_INPUT_BRIDGE_LATENCY_H
+
+#include <atomic>
+#include <cinttypes>
+#include <cstddef>
+#include <cstdint>
+#include <cstdio>
+#include <string>
+
+#include "ArcInputBridgeProtocol.h"
+
+namespace arc {
+
+// Lock-free log-linear latency histogram in the style of HdrHistogram.
+//
+// Values below 2^kSubBucketBits are counted exactly. Above that, every power
+// of two is split into 2^kSubBucketBits linear sub-buckets, giving a relative
+// error of at most 1/16 (~6%). Values are in nanoseconds and anything above
+// kMaxValue (~68s) is clamped into the last bucket.
+//
+// Record() may be called concurrently from any number of threads; it is a
+// couple of relaxed atomic increments. Readers see a consistent-enough
+// snapshot for monitoring but not an atomic one.
+class BridgeInputLatencyHistogram {
+public:
+    static constexpr uint32_t kSubBucketBits = 4;
+    static constexpr uint32_t kSubBucketCount = 1u << kSubBucketBits;
+    static constexpr uint32_t kMaxValueBits = 36;
+    static constexpr uint64_t kMaxValue = (uint64_t{1} << kMaxValueBits) - 1;
+    static constexpr size_t kBucketCount = (kMaxValueBits - kSubBucketBits + 1) * kSubBucketCount;
+
+    void Record(uint64_t valueNs) {
+        mBuckets[BucketIndex(valueNs)].fetch_add(1, std::memory_order_relaxed);
+        mCount.fetch_add(1, std::memory_order_relaxed);
+        uint64_t max = mMax.load(std::memory_order_relaxed);
+        while (valueNs > max &&
+               !mMax.compare_exchange_weak(max, valueNs, std::memory_order_relaxed)) {
+        }
+    }
+
+    uint64_t count() const { return mCount.load(std::memory_order_relaxed); }
+    uint64_t max() const { return mMax.load(std::memory_order_relaxed); }
+
+    // Returns the highest value equivalent to the |percentile| (0-100) sample,
+    // or 0 if nothing was recorded.
+    uint64_t Percentile(double percentile) const {
+        uint64_t total = count();
+        if (total == 0) {
+            return 0;
+        }
+        uint64_t rank = static_cast<uint64_t>(percentile / 100.0 * total + 0.5);
+        if (rank == 0) {
+            rank = 1;
+        }
+        uint64_t seen = 0;
+        for (size_t i = 0; i < kBucketCount; i++) {
+            seen += mBuckets[i].load(std::memory_order_relaxed);
+            if (seen >= rank) {
+                uint64_t upper = BucketUpperBound(i);
+                uint64_t max = this->max();
+                return upper < max ? upper : max;
+            }
+        }
+        return max();
+    }
+
+    void Reset() {
+        for (auto& bucket : mBuckets) {
+            bucket.store(0, std::memory_order_relaxed);
+        }
+        mCount.store(0, std::memory_order_relaxed);
+        mMax.store(0, std::memory_order_relaxed);
+    }
+
+    static size_t BucketIndex(uint64_t value) {
+        if (value > kMaxValue) {
+            value = kMaxValue;
+        }
+        if (value < kSubBucketCount) {
+            return value;
+        }
+        uint32_t shift = 63 - __builtin_clzll(value) - kSubBucketBits;
+        return (shift + 1) * kSubBucketCount + ((value >> shift) & (kSubBucketCount - 1));
+    }
+
+    static uint64_t BucketUpperBound(size_t index) {
+        if (index < kSubBucketCount) {
+            return index;
+        }
+        uint32_t shift = index / kSubBucketCount - 1;
+        uint64_t sub = kSubBucketCount + index % kSubBucketCount;
+        return ((sub + 1) << shift) - 1;
+    }
+
+private:
+    std::atomic<uint64_t> mBuckets[kBucketCount] = {};
+    std::atomic<uint64_t> mCount{0};
+    std::atomic<uint64_t> mMax{0};
+};
+
+// Points along the path of an event at which latency is recorded. Each one is
+// measured from BridgeInputEvent::timestamp, which must be in CLOCK_MONOTONIC
+// nanoseconds, so the difference between two stages tells where the time went.
+enum class BridgeInputLatencyStage {
+    // Producer wrote the event to the transport.
+    ENQUEUE = 0,
+    // Consumer read the event from the transport.
+    DEQUEUE,
+    // Consumer handed the event to the Android input dispatcher.
+    DISPATCH,
+};
+
+static constexpr size_t kBridgeInputLatencyStageCount = 3;
+
+static inline const char* BridgeInputLatencyStageName(BridgeInputLatencyStage stage) {
+    switch (stage) {
+        case BridgeInputLatencyStage::ENQUEUE:
+            return "enqueue";
+        case BridgeInputLatencyStage::DEQUEUE:
+            return "dequeue";
+        case BridgeInputLatencyStage::DISPATCH:
+            return "dispatch";
+    }
+    return "unknown";
+}
+
+// Per-InputEventType, per-stage latency histograms for the input bridge.
+//
+// This is large (a few hundred KB), so allocate one per process rather than
+// on the stack.
+class BridgeInputLatencyTracker {
+public:
+    void Record(InputEventType type, BridgeInputLatencyStage stage, uint64_t latencyNs) {
+        size_t index = static_cast<size_t>(type);
+        if (index >= kInputEventTypeCount) {
+            return;
+        }
+        mHistograms[index][static_cast<size_t>(stage)].Record(latencyNs);
+    }
+
+    // Records the time between |event|'s timestamp and |nowNs| for |stage|.
+    // Events stamped in the future (e.g. by a skewed producer clock) count as
+    // zero latency.
+    void Record(const BridgeInputEvent& event, BridgeInputLatencyStage stage, uint64_t nowNs) {
+        Record(event.type, stage, nowNs > event.timestamp ? nowNs - event.timestamp : 0);
+    }
+
+    void RecordEnqueue(const BridgeInputEvent& event, uint64_t nowNs) {
+        Record(event, BridgeInputLatencyStage::ENQUEUE, nowNs);
+    }
+
+    void RecordDequeue(const BridgeInputEvent& event, uint64_t nowNs) {
+        Record(event, BridgeInputLatencyStage::DEQUEUE, nowNs);
+    }
+
+    void RecordDispatch(const BridgeInputEvent& event, uint64_t nowNs) {
+        Record(event, BridgeInputLatencyStage::DISPATCH, nowNs);
+    }
+
+    const BridgeInputLatencyHistogram& histogram(InputEventType type,
+                                                 BridgeInputLatencyStage stage) const {
+        return mHistograms[static_cast<size_t>(type)][static_cast<size_t>(stage)];
+    }
+
+    void Reset() {
+        for (auto& stages : mHistograms) {
+            for (auto& histogram : stages) {
+                histogram.Reset();
+            }
+        }
+    }
+
+    // Appends a human readable table of count, p50, p99, p99.9 and max in
+    // microseconds for every type and stage that saw at least one event.
+    void Dump(std::string* out) const {
+        char line[160];
+        snprintf(line, sizeof(line), "%-24s %-8s %10s %10s %10s %10s %10s\n", "type", "stage",
+                 "count", "p50(us)", "p99(us)", "p999(us)", "max(us)");
+        out->append(line);
+        for (size_t i = 0; i < kInputEventTypeCount; i++) {
+            for (size_t s = 0; s < kBridgeInputLatencyStageCount; s++) {
+                const BridgeInputLatencyHistogram& h = mHistograms[i][s];
+                if (h.count() == 0) {
+                    continue;
+                }
+                snprintf(line, sizeof(line),
+                         "%-24s %-8s %10" PRIu64 " %10.1f %10.1f %10.1f %10.1f\n",
+                         InputEventTypeName(static_cast<InputEventType>(i)),
+                         BridgeInputLatencyStageName(static_cast<BridgeInputLatencyStage>(s)),
+                         h.count(), h.Percentile(50) / 1000.0, h.Percentile(99) / 1000.0,
+                         h.Percentile(99.9) / 1000.0, h.max() / 1000.0);
+                out->append(line);
+            }
+        }
+    }
+
+private:
+    BridgeInputLatencyHistogram mHistograms[kInputEventTypeCount][kBridgeInputLatencyStageCount];
+};
+
+}  // namespace arc
+
+#endif  // _RUNTIME_ARC_INPUT_BRIDGE_LATENCY_H
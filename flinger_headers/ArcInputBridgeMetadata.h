@@ -0,0 +1,236 @@
+/*
+ * Copyright 2026 The Chromium Authors.
+ *
+ * Permission is hereby granted, free of charge, to any person obtaining a
+ * copy of this software and associated documentation files (the "Software"),
+ * to deal in the Software without restriction, including without limitation
+ * the rights to use, copy, modify, merge, publish, distribute, sublicense,
+ * and/or sell copies of the Software, and to permit persons to whom the
+ * Software is furnished to do so, subject to the following conditions:
+ *
+ * The above copyright notice and this permission notice (including the next
+ * paragraph) shall be included in all copies or substantial portions of the
+ * Software.
+ *
+ * THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+ * IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+ * FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL
+ * THE AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+ * LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING
+ * FROM, OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER
+ * DEALINGS IN THE SOFTWARE.
+ */
+#ifndef _RUNTIME_ARC_INPUT_BRIDGE_METADATA_H
+#define _RUNTIME_ARC_INPUT_BRIDGE_METADATA_H
+
+#include <cstddef>
+#include <cstdint>
+#include <cstring>
+#include <string>
+#include <unordered_map>
+
+#include "ArcInputBridgeProtocol.h"
+
+namespace arc {
+
+// Out-of-band channel for the rare, bulky strings of the input bridge.
+//
+// GAMEPAD_CONNECTED and KEY_CHARACTER_MAP_NAME carry their names inline in
+// 256 and 32 byte buffers. On the compact wire format the producer instead
+// sends the string once as a METADATA record sized to the string, followed by
+// a small *_REF event that refers to it by id. The consumer keeps a side table
+// of ids and expands *_REF events back into the legacy events, so existing
+// gamepad mapping and KCM code is unchanged. BridgeInputStreamDecoder does
+// this for every bundled reader.
+//
+// METADATA is compact-only, so it doesn't widen BridgeInputEvent's union. The
+// legacy layout is part of the pipe ABI and keeps its size regardless; this
+// only slims the compact records, where every hot-path event now fits in
+// under 32 bytes.
+static_assert(sizeof(BridgeInputEventCompactHeader) + sizeof(TouchArgs) < 32, "");
+static_assert(sizeof(BridgeInputEventCompactHeader) + sizeof(PointerArgs) < 32, "");
+static_assert(sizeof(BridgeInputEventCompactHeader) + sizeof(KeyArgs) < 32, "");
+static_assert(sizeof(BridgeInputEventCompactHeader) + sizeof(GamepadArgs) < 32, "");
+static_assert(sizeof(BridgeInputEventCompactHeader) + sizeof(MetadataArgs) +
+                              kArcInputBridgeMaxMetadataSize <=
+                      sizeof(BridgeInputEventCompactHeader) + sizeof(BridgeInputEvent) -
+                              offsetof(BridgeInputEvent, pointer),
+              "METADATA records must fit in kMaxCompactSize");
+
+// Maximum number of strings a producer interns and a consumer keeps. The
+// producer sends names inline once it has this many, so a well-behaved peer
+// never overflows the consumer's table.
+static constexpr size_t kArcInputBridgeMaxMetadataEntries = 256;
+
+// Producer side: splits events with inline strings into METADATA + *_REF.
+// Identical strings are only sent once.
+class BridgeInputMetadataEncoder {
+public:
+    // Space Encode() needs for any event.
+    static constexpr size_t kMaxEncodedSize =
+            2 * (sizeof(BridgeInputEventCompactHeader) + sizeof(BridgeInputEvent) -
+                 offsetof(BridgeInputEvent, pointer));
+
+    // Writes the compact records to send in place of |event| to |out|: a
+    // METADATA record if the string is new, then the *_REF event. Other
+    // events are written as they are. Returns the number of bytes written, or
+    // 0 if |size| is too small.
+    size_t Encode(const BridgeInputEvent& event, uint8_t* out, size_t size) {
+        const char* name;
+        size_t capacity;
+        switch (event.type) {
+            case InputEventType::GAMEPAD_CONNECTED:
+                name = event.gamepad_device_info.name;
+                capacity = sizeof(event.gamepad_device_info.name);
+                break;
+            case InputEventType::KEY_CHARACTER_MAP_NAME:
+                name = event.key_character_map_name.name;
+                capacity = sizeof(event.key_character_map_name.name);
+                break;
+            default:
+                return event.EncodeCompact(out, size);
+        }
+        std::string key(name, strnlen(name, capacity));
+        auto it = mIds.find(key);
+        bool known = it != mIds.end();
+        if (!known && mIds.size() >= kArcInputBridgeMaxMetadataEntries) {
+            return event.EncodeCompact(out, size);
+        }
+        uint32_t id = known ? it->second : mNextId;
+        BridgeInputEvent ref = event.type == InputEventType::GAMEPAD_CONNECTED
+                ? BridgeInputEvent::GamepadConnectedRefEvent(event.timestamp,
+                                                             event.gamepad_device_info, id)
+                : BridgeInputEvent::KeyCharacterMapNameRefEvent(event.timestamp, id);
+        ref.displayId = event.displayId;
+
+        size_t length = 0;
+        if (!known) {
+            uint8_t args[sizeof(MetadataArgs) + kArcInputBridgeMaxMetadataSize];
+            MetadataArgs metadata = {id};
+            memcpy(args, &metadata, sizeof(metadata));
+            memcpy(args + sizeof(metadata), key.data(), key.size());
+            length = BridgeInputEvent::EncodeCompactRecord(event.timestamp, event.displayId,
+                                                           InputEventType::METADATA, args,
+                                                           sizeof(metadata) + key.size(), out,
+                                                           size);
+            if (length == 0) {
+                return 0;
+            }
+        }
+        size_t refLength = ref.EncodeCompact(out + length, size - length);
+        if (refLength == 0) {
+            return 0;
+        }
+        if (!known) {
+            // Only now that both records are out, so a retry resends the string.
+            mIds.emplace(std::move(key), mNextId++);
+        }
+        return length + refLength;
+    }
+
+    // Forgets all strings sent so far. Must be called when the consumer
+    // changes, e.g. after reconnecting.
+    void Reset() {
+        mIds.clear();
+        mNextId = 1;
+    }
+
+private:
+    static_assert(sizeof(GamepadDeviceInfoArgs::name) <= kArcInputBridgeMaxMetadataSize, "");
+    static_assert(sizeof(KeyCharacterMapNameArgs::name) <= kArcInputBridgeMaxMetadataSize, "");
+
+    std::unordered_map<std::string, uint32_t> mIds;
+    uint32_t mNextId = 1;
+};
+
+// Consumer side: remembers METADATA and expands *_REF events.
+class BridgeInputMetadataTable {
+public:
+    // Stores the args of a METADATA record. Returns false and counts the
+    // record in rejectedRecords() if it is malformed, or if it brings a new
+    // id while the table already holds kArcInputBridgeMaxMetadataEntries
+    // strings.
+    bool Store(const uint8_t* args, size_t size) {
+        MetadataArgs metadata;
+        if (size < sizeof(metadata) || size - sizeof(metadata) > kArcInputBridgeMaxMetadataSize) {
+            mRejectedRecords++;
+            return false;
+        }
+        memcpy(&metadata, args, sizeof(metadata));
+        uint32_t id = metadata.id;
+        auto it = mStrings.find(id);
+        if (it == mStrings.end()) {
+            if (mStrings.size() >= kArcInputBridgeMaxMetadataEntries) {
+                mRejectedRecords++;
+                return false;
+            }
+            it = mStrings.emplace(id, std::string()).first;
+        }
+        it->second.assign(reinterpret_cast<const char*>(args) + sizeof(metadata),
+                          size - sizeof(metadata));
+        return true;
+    }
+
+    // Replaces a *_REF event with its legacy counterpart. Leaves other events
+    // alone.
+    void Expand(BridgeInputEvent* event) const {
+        switch (event->type) {
+            case InputEventType::GAMEPAD_CONNECTED_REF: {
+                GamepadDeviceRefArgs ref = event->gamepad_device_ref;
+                *event = {event->timestamp, event->displayId, InputEventType::GAMEPAD_CONNECTED,
+                          {}};
+                GamepadDeviceInfoArgs& info = event->gamepad_device_info;
+                info.id = ref.id;
+                CopyName(ref.nameId, info.name, sizeof(info.name));
+                info.bustype = ref.bustype;
+                info.vendorId = ref.vendorId;
+                info.productId = ref.productId;
+                info.version = ref.version;
+                return;
+            }
+            case InputEventType::KEY_CHARACTER_MAP_NAME_REF: {
+                uint32_t nameId = event->key_character_map_name_ref.nameId;
+                *event = {event->timestamp, event->displayId,
+                          InputEventType::KEY_CHARACTER_MAP_NAME, {}};
+                CopyName(nameId, event->key_character_map_name.name,
+                         sizeof(event->key_character_map_name.name));
+                return;
+            }
+            default:
+                return;
+        }
+    }
+
+    // Returns the string with |id|, or nullptr if it was never received.
+    const std::string* Lookup(uint32_t id) const {
+        auto it = mStrings.find(id);
+        return it == mStrings.end() ? nullptr : &it->second;
+    }
+
+    // Number of METADATA records that were dropped, see Store().
+    uint64_t rejectedRecords() const { return mRejectedRecords; }
+
+    void Reset() { mStrings.clear(); }
+
+private:
+    // Copies the string with |id| into |out| as a NUL-terminated, possibly
+    // truncated, string. Unknown ids produce an empty string.
+    void CopyName(uint32_t id, char* out, size_t capacity) const {
+        const std::string* name = Lookup(id);
+        size_t size = name == nullptr ? 0 : name->size();
+        if (size >= capacity) {
+            size = capacity - 1;
+        }
+        if (size > 0) {
+            memcpy(out, name->data(), size);
+        }
+        out[size] = '\0';
+    }
+
+    std::unordered_map<uint32_t, std::string> mStrings;
+    uint64_t mRejectedRecords = 0;
+};
+
+}  // namespace arc
+
+#endif  // _RUNTIME_ARC_INPUT_BRIDGE_METADATA_H
@@ -0,0 +1,286 @@
+/*
+ * Copyright 2026 The Chromium Authors.
+ *
+ * Permission is hereby granted, free of charge, to any person obtaining a
+ * copy of this software and associated documentation files (the "Software"),
+ * to deal in the Software without restriction, including without limitation
+ * the rights to use, copy, modify, merge, publish, distribute, sublicense,
+ * and/or sell copies of the Software, and to permit persons to whom the
+ * Software is furnished to do so, subject to the following conditions:
+ *
+ * The above copyright notice and this permission notice (including the next
+ * paragraph) shall be included in all copies or substantial portions of the
+ * Software.
+ *
+ * THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+ * IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+ * FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL
+ * THE AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+ * LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING
+ * FROM, OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER
+ * DEALINGS IN THE SOFTWARE.
+ */
+#ifndef _RUNTIME_ARC_INPUT_BRIDGE_MPSC_QUEUE_H
+#define _RUNTIME_ARC_INPUT_BRIDGE_MPSC_QUEUE_H
+
+#include <poll.h>
+#include <sys/eventfd.h>
+#include <unistd.h>
+
+#include <atomic>
+#include <cerrno>
+#include <cstddef>
+#include <cstdint>
+#include <memory>
+
+#include "ArcInputBridgeProtocol.h"
+
+namespace arc {
+
+// Counters kept by each BridgeInputMpscQueue::Producer. They are only written
+// by the producer's own thread and may be read from any thread.
+struct BridgeInputMpscProducerStats {
+    uint64_t pushed;
+    // Pushes rejected because the queue was full.
+    uint64_t full;
+    // Failed attempts to claim a slot because another producer got it first.
+    uint64_t casRetries;
+    // Times this producer had to wake the consumer up.
+    uint64_t wakeups;
+};
+
+struct BridgeInputMpscConsumerStats {
+    uint64_t popped;
+    // Pops that found the next slot claimed but not yet published by a
+    // producer that was preempted mid-push.
+    uint64_t stalls;
+    uint64_t maxDepth;
+};
+
+// In-process front end that lets several producer threads (keyboard, pointer,
+// touch, gamepad) hand BridgeInputEvents to a single forwarding thread without
+// a syscall or a lock, instead of each of them writing to kArcInputBridgePipe.
+//
+// This is a bounded array queue where every slot carries a sequence number:
+// producers claim a slot by advancing |mTail| with a CAS, fill it, then
+// publish it by bumping the slot sequence. The single consumer only reads
+// published slots in order. Events therefore come out in the order their
+// slots were claimed, which means that events pushed by the same Producer are
+// always delivered in the order they were pushed. There is no ordering
+// between different producers beyond that.
+//
+// A producer preempted between claiming and publishing a slot holds back the
+// events queued after it until it resumes; Pop() reports the queue as empty
+// meanwhile and counts a stall.
+class BridgeInputMpscQueue {
+public:
+    // Per-source handle. Each producer thread creates its own; a Producer must
+    // not be shared between threads.
+    class Producer {
+    public:
+        Producer(BridgeInputMpscQueue* queue, uint32_t sourceId)
+              : mQueue(queue), mSourceId(sourceId) {}
+
+        Producer(const Producer&) = delete;
+        Producer& operator=(const Producer&) = delete;
+
+        // Returns false without blocking if the queue is full.
+        bool Push(const BridgeInputEvent& event) { return mQueue->Push(event, mSourceId, &mStats); }
+
+        uint32_t sourceId() const { return mSourceId; }
+
+        BridgeInputMpscProducerStats stats() const {
+            return {mStats.pushed.load(std::memory_order_relaxed),
+                    mStats.full.load(std::memory_order_relaxed),
+                    mStats.casRetries.load(std::memory_order_relaxed),
+                    mStats.wakeups.load(std::memory_order_relaxed)};
+        }
+
+    private:
+        friend class BridgeInputMpscQueue;
+
+        struct Counters {
+            std::atomic<uint64_t> pushed{0};
+            std::atomic<uint64_t> full{0};
+            std::atomic<uint64_t> casRetries{0};
+            std::atomic<uint64_t> wakeups{0};
+        };
+
+        BridgeInputMpscQueue* mQueue;
+        uint32_t mSourceId;
+        // Own cache line so that producers don't false-share their counters.
+        alignas(64) Counters mStats;
+    };
+
+    // |capacity| is rounded up to a power of two, and to at least 2 since a
+    // single slot can't tell a full lap from an empty one. A capacity of 0 or
+    // above 2^31 makes the queue invalid.
+    explicit BridgeInputMpscQueue(uint32_t capacity = 1024)
+          : mCapacity(RoundUpCapacity(capacity)) {
+        if (mCapacity == 0) {
+            return;
+        }
+        mSlots.reset(new Slot[mCapacity]);
+        for (uint32_t i = 0; i < mCapacity; i++) {
+            mSlots[i].sequence.store(i, std::memory_order_relaxed);
+        }
+        mEventFd = eventfd(0, EFD_CLOEXEC | EFD_NONBLOCK);
+    }
+
+    ~BridgeInputMpscQueue() {
+        if (mEventFd >= 0) {
+            close(mEventFd);
+        }
+    }
+
+    BridgeInputMpscQueue(const BridgeInputMpscQueue&) = delete;
+    BridgeInputMpscQueue& operator=(const BridgeInputMpscQueue&) = delete;
+
+    bool IsValid() const { return mCapacity != 0 && mEventFd >= 0; }
+
+    uint32_t capacity() const { return mCapacity; }
+
+    // Becomes readable when a producer pushes while the consumer is blocked
+    // in Wait().
+    int eventFd() const { return mEventFd; }
+
+    // Consumer side. Pops the oldest published event. |outSourceId|, if not
+    // null, receives the id of the Producer that pushed it. Returns false if
+    // nothing is ready.
+    bool Pop(BridgeInputEvent* outEvent, uint32_t* outSourceId = nullptr) {
+        Slot& slot = mSlots[mHead & (mCapacity - 1)];
+        if (slot.sequence.load(std::memory_order_acquire) != mHead + 1) {
+            if (mTail.load(std::memory_order_relaxed) != mHead) {
+                mConsumerStats.stalls++;
+            }
+            return false;
+        }
+        uint64_t depth = mTail.load(std::memory_order_relaxed) - mHead;
+        if (depth > mConsumerStats.maxDepth) {
+            mConsumerStats.maxDepth = depth;
+        }
+        *outEvent = slot.event;
+        if (outSourceId != nullptr) {
+            *outSourceId = slot.sourceId;
+        }
+        slot.sequence.store(mHead + mCapacity, std::memory_order_release);
+        mHead++;
+        mConsumerStats.popped++;
+        return true;
+    }
+
+    // Pops up to |maxCount| events into |outEvents| and returns how many were
+    // popped.
+    size_t Drain(BridgeInputEvent* outEvents, size_t maxCount) {
+        size_t count = 0;
+        while (count < maxCount && Pop(&outEvents[count])) {
+            count++;
+        }
+        return count;
+    }
+
+    // Blocks until an event is ready or |timeoutMs| expires. A negative
+    // timeout waits forever. Returns true if Pop() will succeed.
+    bool Wait(int timeoutMs = -1) {
+        for (;;) {
+            mConsumerWaiting.store(true, std::memory_order_relaxed);
+            // Pairs with the fence in Push(): either the producer sees the
+            // consumer waiting and rings the eventfd, or we see its event.
+            std::atomic_thread_fence(std::memory_order_seq_cst);
+            if (IsReady()) {
+                mConsumerWaiting.store(false, std::memory_order_relaxed);
+                return true;
+            }
+            pollfd pfd{mEventFd, POLLIN, 0};
+            int ret = TEMP_FAILURE_RETRY(poll(&pfd, 1, timeoutMs));
+            mConsumerWaiting.store(false, std::memory_order_relaxed);
+            if (ret <= 0) {
+                return IsReady();
+            }
+            uint64_t count;
+            TEMP_FAILURE_RETRY(read(mEventFd, &count, sizeof(count)));
+        }
+    }
+
+    // Consumer side only.
+    const BridgeInputMpscConsumerStats& consumerStats() const { return mConsumerStats; }
+
+private:
+    struct Slot {
+        std::atomic<uint64_t> sequence;
+        uint32_t sourceId;
+        BridgeInputEvent event;
+    };
+
+    static uint32_t RoundUpCapacity(uint32_t capacity) {
+        if (capacity == 0 || capacity > (uint32_t{1} << 31)) {
+            return 0;
+        }
+        uint32_t rounded = 2;
+        while (rounded < capacity) {
+            rounded <<= 1;
+        }
+        return rounded;
+    }
+
+    bool IsReady() const {
+        return mSlots[mHead & (mCapacity - 1)].sequence.load(std::memory_order_acquire) ==
+                mHead + 1;
+    }
+
+    bool Push(const BridgeInputEvent& event, uint32_t sourceId, Producer::Counters* stats) {
+        uint64_t pos = mTail.load(std::memory_order_relaxed);
+        Slot* slot;
+        for (;;) {
+            slot = &mSlots[pos & (mCapacity - 1)];
+            uint64_t sequence = slot->sequence.load(std::memory_order_acquire);
+            if (sequence == pos) {
+                if (mTail.compare_exchange_weak(pos, pos + 1, std::memory_order_relaxed)) {
+                    break;
+                }
+                // |pos| now holds the current tail.
+            } else if (sequence < pos) {
+                // The slot still holds an event from the previous lap.
+                Increment(&stats->full);
+                return false;
+            } else {
+                pos = mTail.load(std::memory_order_relaxed);
+            }
+            Increment(&stats->casRetries);
+        }
+        slot->sourceId = sourceId;
+        slot->event = event;
+        slot->sequence.store(pos + 1, std::memory_order_release);
+        Increment(&stats->pushed);
+
+        std::atomic_thread_fence(std::memory_order_seq_cst);
+        // Only the first producer to see the consumer asleep rings the
+        // eventfd, so a burst costs a single write.
+        if (mConsumerWaiting.load(std::memory_order_relaxed) &&
+            mConsumerWaiting.exchange(false, std::memory_order_relaxed)) {
+            Increment(&stats->wakeups);
+            uint64_t one = 1;
+            TEMP_FAILURE_RETRY(write(mEventFd, &one, sizeof(one)));
+        }
+        return true;
+    }
+
+    // Counters have a single writer, so a plain load and store is enough.
+    static void Increment(std::atomic<uint64_t>* counter) {
+        counter->store(counter->load(std::memory_order_relaxed) + 1, std::memory_order_relaxed);
+    }
+
+    const uint32_t mCapacity;
+    std::unique_ptr<Slot[]> mSlots;
+    int mEventFd = -1;
+    // Written by producers only.
+    alignas(64) std::atomic<uint64_t> mTail{0};
+    alignas(64) std::atomic<bool> mConsumerWaiting{false};
+    // Consumer only.
+    alignas(64) uint64_t mHead = 0;
+    BridgeInputMpscConsumerStats mConsumerStats = {};
+};
+
+}  // namespace arc
+
+#endif  // _RUNTIME_ARC_INPUT_BRIDGE_MPSC_QUEUE_H
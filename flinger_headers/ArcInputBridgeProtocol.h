@@ -20,10 +20,16 @@
  * FROM, OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER
  * DEALINGS IN THE SOFTWARE.
  */
+
+// Generated by codegen/inputbridge_codegen.py from
+// schema/ArcInputBridgeProtocol.xml. Do not edit.
+
 #ifndef _RUNTIME_ARC_INPUT_BRIDGE_PROTOCOL_H
 #define _RUNTIME_ARC_INPUT_BRIDGE_PROTOCOL_H
 
+#include <cstddef>
 #include <cstdint>
+#include <cstring>
 
 // Hack: major/minor may be defined by stdlib in error.
 // see https://sourceware.org/bugzilla/show_bug.cgi?id=19239
@@ -35,7 +41,31 @@ namespace arc {
 // Location of the named pipe for communicating events
 static const char* kArcInputBridgePipe = "/var/run/inputbridge/inputbridge";
 
-enum class InputEventType {
+// Wire formats understood on kArcInputBridgePipe. The legacy format writes
+// each BridgeInputEvent as-is. The compact format writes a
+// BridgeInputEventCompactHeader followed only by the args struct used by the
+// event type, see BridgeInputEvent::EncodeCompact.
+//
+// A stream always starts in the legacy format. A producer switches to the
+// compact format by sending a legacy WIRE_FORMAT event carrying
+// kArcInputBridgeWireVersionCompact; every record after it is compact. Old
+// producers never send WIRE_FORMAT so they keep working with new consumers.
+//
+// The consumer decides whether the producer may switch, since an old
+// consumer can't decode compact records: see kArcInputBridgeWireVersionFile.
+static constexpr uint8_t kArcInputBridgeWireVersionLegacy = 0;
+static constexpr uint8_t kArcInputBridgeWireVersionCompact = 1;
+
+// File in which a consumer that understands WIRE_FORMAT publishes the
+// highest wire version it decodes, as a single byte. The consumer writes it
+// before it opens kArcInputBridgePipe and removes it when it closes the
+// pipe. A producer reads it after its open() of the pipe returns, which
+// only happens once the consumer has the pipe open, and stays in the legacy
+// format if the file is missing. Old consumers never write it. See
+// ArcInputBridgeStream.h.
+static const char* kArcInputBridgeWireVersionFile = "/var/run/inputbridge/inputbridge_wire_version";
+
+enum class InputEventType : uint8_t {
     RESET = 0,
 
     POINTER_ENTER,
@@ -86,7 +116,155 @@ enum class InputEventType {
     DISPLAY_METRICS,
 
     KEY_CHARACTER_MAP_NAME,
-} __attribute__((packed));
+
+    // event for switching the wire format of the stream, see
+    // kArcInputBridgeWireVersionCompact
+    WIRE_FORMAT,
+
+    // header of a batch of events, see ArcInputBridgeFrameBatch.h
+    FRAME_BATCH,
+
+    // Out-of-band metadata, see ArcInputBridgeMetadata.h. METADATA carries a
+    // string that the *_REF events refer to by id, so the rare but bulky
+    // payloads of GAMEPAD_CONNECTED and KEY_CHARACTER_MAP_NAME don't have to
+    // travel inline. Compact-only.
+    METADATA,
+    GAMEPAD_CONNECTED_REF,
+    KEY_CHARACTER_MAP_NAME_REF,
+
+    // all axis and button changes of one gamepad frame in a single event, see
+    // ArcInputBridgeGamepadSnapshot.h
+    GAMEPAD_SNAPSHOT,
+
+    // periodic producer clock reading for translating timestamps into the
+    // consumer's clock, see ArcInputBridgeClockSync.h
+    CLOCK_SYNC,
+
+    // a delta encoded frame of TOUCH_MOVE events and its TOUCH_FRAME, see
+    // ArcInputBridgeTouchDelta.h. Compact-only.
+    TOUCH_DELTA_FRAME,
+};
+
+// Number of InputEventType values.
+static constexpr size_t kInputEventTypeCount =
+        static_cast<size_t>(InputEventType::TOUCH_DELTA_FRAME) + 1;
+
+static inline const char* InputEventTypeName(InputEventType type) {
+    switch (type) {
+        case InputEventType::RESET:
+            return "RESET";
+        case InputEventType::POINTER_ENTER:
+            return "POINTER_ENTER";
+        case InputEventType::POINTER_MOVE:
+            return "POINTER_MOVE";
+        case InputEventType::POINTER_MOVE_RELATIVE:
+            return "POINTER_MOVE_RELATIVE";
+        case InputEventType::POINTER_LEAVE:
+            return "POINTER_LEAVE";
+        case InputEventType::POINTER_BUTTON:
+            return "POINTER_BUTTON";
+        case InputEventType::POINTER_SCROLL_X:
+            return "POINTER_SCROLL_X";
+        case InputEventType::POINTER_SCROLL_Y:
+            return "POINTER_SCROLL_Y";
+        case InputEventType::POINTER_SCROLL_DISCRETE:
+            return "POINTER_SCROLL_DISCRETE";
+        case InputEventType::POINTER_SCROLL_STOP:
+            return "POINTER_SCROLL_STOP";
+        case InputEventType::POINTER_FRAME:
+            return "POINTER_FRAME";
+        case InputEventType::TOUCH_DOWN:
+            return "TOUCH_DOWN";
+        case InputEventType::TOUCH_MOVE:
+            return "TOUCH_MOVE";
+        case InputEventType::TOUCH_UP:
+            return "TOUCH_UP";
+        case InputEventType::TOUCH_CANCEL:
+            return "TOUCH_CANCEL";
+        case InputEventType::TOUCH_SHAPE:
+            return "TOUCH_SHAPE";
+        case InputEventType::TOUCH_TOOL_TYPE:
+            return "TOUCH_TOOL_TYPE";
+        case InputEventType::TOUCH_FORCE:
+            return "TOUCH_FORCE";
+        case InputEventType::TOUCH_TILT:
+            return "TOUCH_TILT";
+        case InputEventType::TOUCH_FRAME:
+            return "TOUCH_FRAME";
+        case InputEventType::GESTURE_PINCH_BEGIN:
+            return "GESTURE_PINCH_BEGIN";
+        case InputEventType::GESTURE_PINCH_UPDATE:
+            return "GESTURE_PINCH_UPDATE";
+        case InputEventType::GESTURE_PINCH_END:
+            return "GESTURE_PINCH_END";
+        case InputEventType::GESTURE_SWIPE_BEGIN:
+            return "GESTURE_SWIPE_BEGIN";
+        case InputEventType::GESTURE_SWIPE_UPDATE:
+            return "GESTURE_SWIPE_UPDATE";
+        case InputEventType::GESTURE_SWIPE_END:
+            return "GESTURE_SWIPE_END";
+        case InputEventType::KEY:
+            return "KEY";
+        case InputEventType::KEY_MODIFIERS:
+            return "KEY_MODIFIERS";
+        case InputEventType::KEY_RESET:
+            return "KEY_RESET";
+        case InputEventType::GAMEPAD_CONNECTED:
+            return "GAMEPAD_CONNECTED";
+        case InputEventType::GAMEPAD_DISCONNECTED:
+            return "GAMEPAD_DISCONNECTED";
+        case InputEventType::GAMEPAD_AXIS_INFO:
+            return "GAMEPAD_AXIS_INFO";
+        case InputEventType::GAMEPAD_ACTIVATED:
+            return "GAMEPAD_ACTIVATED";
+        case InputEventType::GAMEPAD_AXIS:
+            return "GAMEPAD_AXIS";
+        case InputEventType::GAMEPAD_BUTTON:
+            return "GAMEPAD_BUTTON";
+        case InputEventType::GAMEPAD_FRAME:
+            return "GAMEPAD_FRAME";
+        case InputEventType::SWITCH:
+            return "SWITCH";
+        case InputEventType::DISPLAY_METRICS:
+            return "DISPLAY_METRICS";
+        case InputEventType::KEY_CHARACTER_MAP_NAME:
+            return "KEY_CHARACTER_MAP_NAME";
+        case InputEventType::WIRE_FORMAT:
+            return "WIRE_FORMAT";
+        case InputEventType::FRAME_BATCH:
+            return "FRAME_BATCH";
+        case InputEventType::METADATA:
+            return "METADATA";
+        case InputEventType::GAMEPAD_CONNECTED_REF:
+            return "GAMEPAD_CONNECTED_REF";
+        case InputEventType::KEY_CHARACTER_MAP_NAME_REF:
+            return "KEY_CHARACTER_MAP_NAME_REF";
+        case InputEventType::GAMEPAD_SNAPSHOT:
+            return "GAMEPAD_SNAPSHOT";
+        case InputEventType::CLOCK_SYNC:
+            return "CLOCK_SYNC";
+        case InputEventType::TOUCH_DELTA_FRAME:
+            return "TOUCH_DELTA_FRAME";
+    }
+    return "UNKNOWN";
+}
+
+// Returns true for the events that terminate a frame.
+static inline bool IsFrameTerminator(InputEventType type) {
+    return type == InputEventType::POINTER_FRAME || type == InputEventType::TOUCH_FRAME ||
+            type == InputEventType::GAMEPAD_FRAME;
+}
+
+// Returns true for the events whose args BridgeInputEvent can't hold. They
+// only exist as compact records, written with
+// BridgeInputEvent::EncodeCompactRecord(), and BridgeInputStreamDecoder
+// consumes them rather than hands them out.
+static inline bool IsCompactOnly(InputEventType type) {
+    return type == InputEventType::METADATA || type == InputEventType::TOUCH_DELTA_FRAME;
+}
+
+// Args of the event types that don't carry any.
+struct NoArgs {};
 
 struct PointerArgs {
     float x;
@@ -115,7 +293,7 @@ struct ButtonArgs {
     uint32_t state;
 };
 
-enum class TouchToolType { TOUCH = 0, PEN, ERASER } __attribute__((packed));
+enum class TouchToolType : uint8_t { TOUCH = 0, PEN, ERASER };
 
 struct TouchArgs {
     int32_t id;
@@ -191,10 +369,10 @@ struct DisplayMetricsArgs {
 } __attribute__((packed));
 
 struct KeyCharacterMapNameArgs {
-  // XKB layout name. The longest one we have is "us(workman-intl)" (16
-  // characters) so it should be sufficient. KCM converter will also check the
-  // name doesn't exceed the limit at build time.
-  char name[32];
+    // XKB layout name. The longest one we have is "us(workman-intl)" (16
+    // characters) so it should be sufficient. KCM converter will also check the
+    // name doesn't exceed the limit at build time.
+    char name[32];
 } __attribute__((packed));
 
 struct RelativePointerArgs {
@@ -202,6 +380,92 @@ struct RelativePointerArgs {
     float dy;
 } __attribute__((packed));
 
+struct WireFormatArgs {
+    // One of the kArcInputBridgeWireVersion* constants.
+    uint8_t version;
+} __attribute__((packed));
+
+struct FrameBatchArgs {
+    // Number of events following this one that belong to the batch.
+    uint32_t count;
+} __attribute__((packed));
+
+// Maximum length of the string of a METADATA record.
+static constexpr size_t kArcInputBridgeMaxMetadataSize = 256;
+
+// Fixed part of a METADATA record. The string follows it up to the end of
+// the record, without a NUL terminator.
+struct MetadataArgs {
+    // Producer-assigned id, referenced by the *_REF events.
+    uint32_t id;
+} __attribute__((packed));
+
+struct GamepadDeviceRefArgs {
+    int32_t id;
+    // Id of the METADATA holding the device name.
+    uint32_t nameId;
+    uint16_t bustype;
+    uint16_t vendorId;
+    uint16_t productId;
+    uint16_t version;
+} __attribute__((packed));
+
+struct KeyCharacterMapNameRefArgs {
+    // Id of the METADATA holding the XKB layout name.
+    uint32_t nameId;
+} __attribute__((packed));
+
+// Number of axes and buttons that fit in GamepadSnapshotArgs::changedAxes and
+// GamepadSnapshotArgs::changedButtons, and number of changed values one
+// snapshot can carry.
+static constexpr int32_t kGamepadSnapshotAxisCount = 64;
+static constexpr int32_t kGamepadSnapshotButtonCount = 32;
+static constexpr uint32_t kGamepadSnapshotMaxValues = 60;
+
+struct GamepadSnapshotArgs {
+    int32_t id;
+    // Bit n is set if axis n changed.
+    uint64_t changedAxes;
+    // Bit n is set if button n changed.
+    uint32_t changedButtons;
+    // Bit n is set if button n is pressed. Only meaningful for changed buttons.
+    uint32_t pressedButtons;
+    // Whether the snapshot ends a frame, i.e. replaces a GAMEPAD_FRAME.
+    bool endsFrame;
+    // Values of the changed axes in ascending order, followed by the analog
+    // values of the changed buttons in ascending order.
+    float values[kGamepadSnapshotMaxValues];
+
+    uint32_t valueCount() const {
+        return __builtin_popcountll(changedAxes) + __builtin_popcount(changedButtons);
+    }
+} __attribute__((packed));
+
+struct ClockSyncArgs {
+    // clockid_t of the clock the producer stamps events with, e.g.
+    // CLOCK_MONOTONIC. The event timestamp is a reading of this clock.
+    int32_t clockId;
+    // Incremented for every CLOCK_SYNC, so the consumer can spot gaps.
+    uint32_t sequence;
+} __attribute__((packed));
+
+// Fixed part of a TOUCH_DELTA_FRAME record. The rest of the encoded frame
+// follows it up to the end of the record.
+struct TouchDeltaFrameArgs {
+    // First byte of the encoded frame, see touch_delta::kFlagKeyframe.
+    uint8_t flags;
+} __attribute__((packed));
+
+// Header of a record in the compact wire format. |length| covers the header
+// and the args that follow it, so consumers can skip records of types they
+// don't know about.
+struct BridgeInputEventCompactHeader {
+    uint16_t length;
+    uint64_t timestamp;
+    int32_t displayId;
+    InputEventType type;
+} __attribute__((packed));
+
 // Union-like class describing an event. The InputEventType describes which
 // of member of the union contains the data of this event.
 struct BridgeInputEvent {
@@ -213,9 +477,9 @@ struct BridgeInputEvent {
     union {
         PointerArgs pointer;
         KeyArgs key;
-        TouchArgs touch;
         MetaArgs meta;
         ButtonArgs button;
+        TouchArgs touch;
         GestureArgs gesture;
         GesturePinchArgs gesture_pinch;
         GestureSwipeArgs gesture_swipe;
@@ -226,35 +490,46 @@ struct BridgeInputEvent {
         DisplayMetricsArgs display_metrics;
         KeyCharacterMapNameArgs key_character_map_name;
         RelativePointerArgs relativePointer;
+        WireFormatArgs wire_format;
+        FrameBatchArgs frame_batch;
+        GamepadDeviceRefArgs gamepad_device_ref;
+        KeyCharacterMapNameRefArgs key_character_map_name_ref;
+        GamepadSnapshotArgs gamepad_snapshot;
+        ClockSyncArgs clock_sync;
     };
 
     static BridgeInputEvent ResetEvent(uint64_t timestamp) {
         return {timestamp, -1, InputEventType::RESET, {}};
     }
 
-    static BridgeInputEvent KeyEvent(uint64_t timestamp, uint32_t scanCode,
-                                     uint32_t state, uint32_t serial) {
+    static BridgeInputEvent KeyEvent(uint64_t timestamp, uint32_t scanCode, uint32_t state,
+                                     uint32_t serial) {
         BridgeInputEvent event{timestamp, -1, InputEventType::KEY, {}};
-        event.key = {scanCode, state, serial};
+        event.key.scanCode = scanCode;
+        event.key.state = state;
+        event.key.serial = serial;
         return event;
     }
 
     static BridgeInputEvent KeyModifiersEvent(uint64_t timestamp, uint32_t modifiers) {
         BridgeInputEvent event{timestamp, -1, InputEventType::KEY_MODIFIERS, {}};
-        event.meta = {modifiers};
+        event.meta.metaState = modifiers;
         return event;
     }
 
     static BridgeInputEvent PointerEvent(uint64_t timestamp, InputEventType type, float x = 0,
                                          float y = 0, bool discrete = false) {
         BridgeInputEvent event{timestamp, -1, type, {}};
-        event.pointer = {x, y, discrete};
+        event.pointer.x = x;
+        event.pointer.y = y;
+        event.pointer.discrete = discrete;
         return event;
     }
 
     static BridgeInputEvent PointerButtonEvent(uint64_t timestamp, uint32_t code, uint32_t state) {
         BridgeInputEvent event{timestamp, -1, InputEventType::POINTER_BUTTON, {}};
-        event.button = {code, state};
+        event.button.code = code;
+        event.button.state = state;
         return event;
     }
 
@@ -293,14 +568,15 @@ struct BridgeInputEvent {
         return event;
     }
 
-    static BridgeInputEvent GamepadConnectedEvent(int32_t id) {
-        BridgeInputEvent event{0, -1, InputEventType::GAMEPAD_CONNECTED, {}};
+    // A timestamp of 0 means unknown; consumers stamp such events on receipt.
+    static BridgeInputEvent GamepadConnectedEvent(int32_t id, uint64_t timestamp = 0) {
+        BridgeInputEvent event{timestamp, -1, InputEventType::GAMEPAD_CONNECTED, {}};
         event.gamepad.id = id;
         return event;
     }
 
-    static BridgeInputEvent GamepadDisconnectedEvent(int32_t id) {
-        BridgeInputEvent event{0, -1, InputEventType::GAMEPAD_DISCONNECTED, {}};
+    static BridgeInputEvent GamepadDisconnectedEvent(int32_t id, uint64_t timestamp = 0) {
+        BridgeInputEvent event{timestamp, -1, InputEventType::GAMEPAD_DISCONNECTED, {}};
         event.gamepad.id = id;
         return event;
     }
@@ -330,14 +606,347 @@ struct BridgeInputEvent {
         return event;
     }
 
+    static BridgeInputEvent GamepadSnapshotEvent(uint64_t timestamp, int32_t id) {
+        BridgeInputEvent event{timestamp, -1, InputEventType::GAMEPAD_SNAPSHOT, {}};
+        event.gamepad_snapshot.id = id;
+        return event;
+    }
+
+    static BridgeInputEvent ClockSyncEvent(uint64_t timestamp, int32_t clockId, uint32_t sequence) {
+        BridgeInputEvent event{timestamp, -1, InputEventType::CLOCK_SYNC, {}};
+        event.clock_sync.clockId = clockId;
+        event.clock_sync.sequence = sequence;
+        return event;
+    }
+
     static BridgeInputEvent SwitchEvent(uint64_t timestamp, int32_t switchCode, int32_t state) {
         BridgeInputEvent event{timestamp, -1, InputEventType::SWITCH, {}};
         event.switches.switchCode = switchCode;
         event.switches.state = state;
         return event;
     }
+
+    static BridgeInputEvent WireFormatEvent(uint64_t timestamp, uint8_t version) {
+        BridgeInputEvent event{timestamp, -1, InputEventType::WIRE_FORMAT, {}};
+        event.wire_format.version = version;
+        return event;
+    }
+
+    static BridgeInputEvent FrameBatchEvent(uint64_t timestamp, uint32_t count) {
+        BridgeInputEvent event{timestamp, -1, InputEventType::FRAME_BATCH, {}};
+        event.frame_batch.count = count;
+        return event;
+    }
+
+    static BridgeInputEvent GamepadConnectedRefEvent(uint64_t timestamp,
+                                                     const GamepadDeviceInfoArgs& info,
+                                                     uint32_t nameId) {
+        BridgeInputEvent event{timestamp, -1, InputEventType::GAMEPAD_CONNECTED_REF, {}};
+        event.gamepad_device_ref = {info.id,        nameId,         info.bustype,
+                                    info.vendorId, info.productId, info.version};
+        return event;
+    }
+
+    static BridgeInputEvent KeyCharacterMapNameRefEvent(uint64_t timestamp, uint32_t nameId) {
+        BridgeInputEvent event{timestamp, -1, InputEventType::KEY_CHARACTER_MAP_NAME_REF, {}};
+        event.key_character_map_name_ref.nameId = nameId;
+        return event;
+    }
+
+    // Returns the size of the args struct used by |type|. Unknown types use
+    // the whole union.
+    static size_t ArgsSize(InputEventType type);
+
+    // Returns the number of bytes EncodeCompact writes for this event.
+    // Only the used part of GamepadSnapshotArgs::values is sent.
+    size_t CompactSize() const {
+        if (type == InputEventType::GAMEPAD_SNAPSHOT) {
+            size_t count = gamepad_snapshot.valueCount();
+            if (count > kGamepadSnapshotMaxValues) {
+                count = kGamepadSnapshotMaxValues;
+            }
+            return sizeof(BridgeInputEventCompactHeader) + offsetof(GamepadSnapshotArgs, values) +
+                    count * sizeof(float);
+        }
+        return sizeof(BridgeInputEventCompactHeader) + ArgsSize(type);
+    }
+
+    // Writes this event in the compact wire format to |out|. Returns the number
+    // of bytes written, or 0 if |size| is too small.
+    size_t EncodeCompact(uint8_t* out, size_t size) const;
+
+    // Reads one compact record from |in| into |outEvent|. Returns the number of
+    // bytes consumed, or 0 if |in| doesn't hold a complete, well-formed record.
+    // Once |size| reaches kMaxCompactSize a return value of 0 means the stream
+    // is corrupt.
+    // Records of compact-only types are consumed with their args left zeroed,
+    // since the event can't hold them; their args are the record's last
+    // length - sizeof(BridgeInputEventCompactHeader) bytes.
+    static size_t DecodeCompact(const uint8_t* in, size_t size, BridgeInputEvent* outEvent);
+
+    // Writes a record of the compact-only |type| with |args| as its args to
+    // |out|. Returns the number of bytes written, or 0 if |size| is too small or
+    // the record would be longer than kMaxCompactSize.
+    static size_t EncodeCompactRecord(uint64_t timestamp, int32_t displayId,
+                                      InputEventType type, const void* args,
+                                      size_t argsSize, uint8_t* out, size_t size);
+
+    static const size_t kMaxCompactSize;
 } __attribute__((packed));
 
+// The layouts below are the pipe ABI. They are computed from the schema by the
+// generator, so these only fail if the compiler lays a struct out differently.
+static_assert(sizeof(BridgeInputEvent) == 281, "wire format changed");
+static_assert(offsetof(BridgeInputEvent, pointer) == 13, "wire format changed");
+static_assert(sizeof(BridgeInputEventCompactHeader) == 15, "wire format changed");
+static_assert(sizeof(PointerArgs) == 9, "wire format changed");
+static_assert(offsetof(PointerArgs, y) == 4, "wire format changed");
+static_assert(offsetof(PointerArgs, discrete) == 8, "wire format changed");
+static_assert(sizeof(KeyArgs) == 12, "wire format changed");
+static_assert(offsetof(KeyArgs, state) == 4, "wire format changed");
+static_assert(offsetof(KeyArgs, serial) == 8, "wire format changed");
+static_assert(sizeof(MetaArgs) == 4, "wire format changed");
+static_assert(sizeof(ButtonArgs) == 8, "wire format changed");
+static_assert(offsetof(ButtonArgs, state) == 4, "wire format changed");
+static_assert(sizeof(TouchArgs) == 12, "wire format changed");
+static_assert(offsetof(TouchArgs, x) == 4, "wire format changed");
+static_assert(offsetof(TouchArgs, major) == 4, "wire format changed");
+static_assert(offsetof(TouchArgs, force) == 4, "wire format changed");
+static_assert(offsetof(TouchArgs, tool) == 4, "wire format changed");
+static_assert(offsetof(TouchArgs, y) == 8, "wire format changed");
+static_assert(offsetof(TouchArgs, minor) == 8, "wire format changed");
+static_assert(sizeof(GestureArgs) == 5, "wire format changed");
+static_assert(offsetof(GestureArgs, cancelled) == 4, "wire format changed");
+static_assert(sizeof(GesturePinchArgs) == 4, "wire format changed");
+static_assert(sizeof(GestureSwipeArgs) == 8, "wire format changed");
+static_assert(offsetof(GestureSwipeArgs, dy) == 4, "wire format changed");
+static_assert(sizeof(GamepadDeviceInfoArgs) == 268, "wire format changed");
+static_assert(offsetof(GamepadDeviceInfoArgs, name) == 4, "wire format changed");
+static_assert(offsetof(GamepadDeviceInfoArgs, bustype) == 260, "wire format changed");
+static_assert(offsetof(GamepadDeviceInfoArgs, vendorId) == 262, "wire format changed");
+static_assert(offsetof(GamepadDeviceInfoArgs, productId) == 264, "wire format changed");
+static_assert(offsetof(GamepadDeviceInfoArgs, version) == 266, "wire format changed");
+static_assert(sizeof(GamepadAxisInfoArgs) == 28, "wire format changed");
+static_assert(offsetof(GamepadAxisInfoArgs, index) == 4, "wire format changed");
+static_assert(offsetof(GamepadAxisInfoArgs, minValue) == 8, "wire format changed");
+static_assert(offsetof(GamepadAxisInfoArgs, maxValue) == 12, "wire format changed");
+static_assert(offsetof(GamepadAxisInfoArgs, flat) == 16, "wire format changed");
+static_assert(offsetof(GamepadAxisInfoArgs, fuzz) == 20, "wire format changed");
+static_assert(offsetof(GamepadAxisInfoArgs, resolution) == 24, "wire format changed");
+static_assert(sizeof(GamepadArgs) == 13, "wire format changed");
+static_assert(offsetof(GamepadArgs, button) == 4, "wire format changed");
+static_assert(offsetof(GamepadArgs, axis) == 4, "wire format changed");
+static_assert(offsetof(GamepadArgs, pressed) == 8, "wire format changed");
+static_assert(offsetof(GamepadArgs, value) == 9, "wire format changed");
+static_assert(sizeof(SwitchArgs) == 8, "wire format changed");
+static_assert(offsetof(SwitchArgs, state) == 4, "wire format changed");
+static_assert(sizeof(DisplayMetricsArgs) == 12, "wire format changed");
+static_assert(offsetof(DisplayMetricsArgs, height) == 4, "wire format changed");
+static_assert(offsetof(DisplayMetricsArgs, ui_scale) == 8, "wire format changed");
+static_assert(sizeof(KeyCharacterMapNameArgs) == 32, "wire format changed");
+static_assert(sizeof(RelativePointerArgs) == 8, "wire format changed");
+static_assert(offsetof(RelativePointerArgs, dy) == 4, "wire format changed");
+static_assert(sizeof(WireFormatArgs) == 1, "wire format changed");
+static_assert(sizeof(FrameBatchArgs) == 4, "wire format changed");
+static_assert(sizeof(MetadataArgs) == 4, "wire format changed");
+static_assert(sizeof(GamepadDeviceRefArgs) == 16, "wire format changed");
+static_assert(offsetof(GamepadDeviceRefArgs, nameId) == 4, "wire format changed");
+static_assert(offsetof(GamepadDeviceRefArgs, bustype) == 8, "wire format changed");
+static_assert(offsetof(GamepadDeviceRefArgs, vendorId) == 10, "wire format changed");
+static_assert(offsetof(GamepadDeviceRefArgs, productId) == 12, "wire format changed");
+static_assert(offsetof(GamepadDeviceRefArgs, version) == 14, "wire format changed");
+static_assert(sizeof(KeyCharacterMapNameRefArgs) == 4, "wire format changed");
+static_assert(sizeof(GamepadSnapshotArgs) == 261, "wire format changed");
+static_assert(offsetof(GamepadSnapshotArgs, changedAxes) == 4, "wire format changed");
+static_assert(offsetof(GamepadSnapshotArgs, changedButtons) == 12, "wire format changed");
+static_assert(offsetof(GamepadSnapshotArgs, pressedButtons) == 16, "wire format changed");
+static_assert(offsetof(GamepadSnapshotArgs, endsFrame) == 20, "wire format changed");
+static_assert(offsetof(GamepadSnapshotArgs, values) == 21, "wire format changed");
+static_assert(sizeof(ClockSyncArgs) == 8, "wire format changed");
+static_assert(offsetof(ClockSyncArgs, sequence) == 4, "wire format changed");
+static_assert(sizeof(TouchDeltaFrameArgs) == 1, "wire format changed");
+
+inline const size_t BridgeInputEvent::kMaxCompactSize =
+        sizeof(BridgeInputEventCompactHeader) + sizeof(BridgeInputEvent) -
+        offsetof(BridgeInputEvent, pointer);
+
+inline size_t BridgeInputEvent::ArgsSize(InputEventType type) {
+    switch (type) {
+        case InputEventType::RESET:
+        case InputEventType::KEY_RESET:
+            return 0;
+        case InputEventType::POINTER_ENTER:
+        case InputEventType::POINTER_MOVE:
+        case InputEventType::POINTER_LEAVE:
+        case InputEventType::POINTER_SCROLL_X:
+        case InputEventType::POINTER_SCROLL_Y:
+        case InputEventType::POINTER_SCROLL_DISCRETE:
+        case InputEventType::POINTER_SCROLL_STOP:
+        case InputEventType::POINTER_FRAME:
+            return sizeof(PointerArgs);
+        case InputEventType::POINTER_MOVE_RELATIVE:
+            return sizeof(RelativePointerArgs);
+        case InputEventType::POINTER_BUTTON:
+            return sizeof(ButtonArgs);
+        case InputEventType::TOUCH_DOWN:
+        case InputEventType::TOUCH_MOVE:
+        case InputEventType::TOUCH_UP:
+        case InputEventType::TOUCH_CANCEL:
+        case InputEventType::TOUCH_SHAPE:
+        case InputEventType::TOUCH_TOOL_TYPE:
+        case InputEventType::TOUCH_FORCE:
+        case InputEventType::TOUCH_TILT:
+        case InputEventType::TOUCH_FRAME:
+            return sizeof(TouchArgs);
+        case InputEventType::GESTURE_PINCH_BEGIN:
+        case InputEventType::GESTURE_PINCH_END:
+        case InputEventType::GESTURE_SWIPE_BEGIN:
+        case InputEventType::GESTURE_SWIPE_END:
+            return sizeof(GestureArgs);
+        case InputEventType::GESTURE_PINCH_UPDATE:
+            return sizeof(GesturePinchArgs);
+        case InputEventType::GESTURE_SWIPE_UPDATE:
+            return sizeof(GestureSwipeArgs);
+        case InputEventType::KEY:
+            return sizeof(KeyArgs);
+        case InputEventType::KEY_MODIFIERS:
+            return sizeof(MetaArgs);
+        case InputEventType::GAMEPAD_CONNECTED:
+            return sizeof(GamepadDeviceInfoArgs);
+        case InputEventType::GAMEPAD_DISCONNECTED:
+        case InputEventType::GAMEPAD_ACTIVATED:
+        case InputEventType::GAMEPAD_AXIS:
+        case InputEventType::GAMEPAD_BUTTON:
+        case InputEventType::GAMEPAD_FRAME:
+            return sizeof(GamepadArgs);
+        case InputEventType::GAMEPAD_AXIS_INFO:
+            return sizeof(GamepadAxisInfoArgs);
+        case InputEventType::SWITCH:
+            return sizeof(SwitchArgs);
+        case InputEventType::DISPLAY_METRICS:
+            return sizeof(DisplayMetricsArgs);
+        case InputEventType::KEY_CHARACTER_MAP_NAME:
+            return sizeof(KeyCharacterMapNameArgs);
+        case InputEventType::WIRE_FORMAT:
+            return sizeof(WireFormatArgs);
+        case InputEventType::FRAME_BATCH:
+            return sizeof(FrameBatchArgs);
+        case InputEventType::METADATA:
+            return sizeof(MetadataArgs);
+        case InputEventType::GAMEPAD_CONNECTED_REF:
+            return sizeof(GamepadDeviceRefArgs);
+        case InputEventType::KEY_CHARACTER_MAP_NAME_REF:
+            return sizeof(KeyCharacterMapNameRefArgs);
+        case InputEventType::GAMEPAD_SNAPSHOT:
+            return sizeof(GamepadSnapshotArgs);
+        case InputEventType::CLOCK_SYNC:
+            return sizeof(ClockSyncArgs);
+        case InputEventType::TOUCH_DELTA_FRAME:
+            return sizeof(TouchDeltaFrameArgs);
+    }
+    return sizeof(BridgeInputEvent) - offsetof(BridgeInputEvent, pointer);
+}
+
+inline size_t BridgeInputEvent::EncodeCompact(uint8_t* out, size_t size) const {
+    size_t length = CompactSize();
+    if (size < length) {
+        return 0;
+    }
+    BridgeInputEventCompactHeader header{static_cast<uint16_t>(length), timestamp, displayId,
+                                         type};
+    memcpy(out, &header, sizeof(header));
+    memcpy(out + sizeof(header), reinterpret_cast<const uint8_t*>(this) +
+                   offsetof(BridgeInputEvent, pointer),
+           length - sizeof(header));
+    return length;
+}
+
+inline size_t BridgeInputEvent::DecodeCompact(const uint8_t* in, size_t size,
+                                              BridgeInputEvent* outEvent) {
+    BridgeInputEventCompactHeader header;
+    if (size < sizeof(header)) {
+        return 0;
+    }
+    memcpy(&header, in, sizeof(header));
+    if (header.length < sizeof(header) || header.length > kMaxCompactSize ||
+        header.length > size) {
+        return 0;
+    }
+    *outEvent = {header.timestamp, header.displayId, header.type, {}};
+    if (IsCompactOnly(header.type)) {
+        return header.length;
+    }
+    size_t argsSize = header.length - sizeof(header);
+    memcpy(reinterpret_cast<uint8_t*>(outEvent) + offsetof(BridgeInputEvent, pointer),
+           in + sizeof(header), argsSize);
+    return header.length;
+}
+
+inline size_t BridgeInputEvent::EncodeCompactRecord(uint64_t timestamp, int32_t displayId,
+                                                   InputEventType type, const void* args,
+                                                   size_t argsSize, uint8_t* out,
+                                                   size_t size) {
+    size_t length = sizeof(BridgeInputEventCompactHeader) + argsSize;
+    if (size < length || length > kMaxCompactSize) {
+        return 0;
+    }
+    BridgeInputEventCompactHeader header{static_cast<uint16_t>(length), timestamp, displayId,
+                                         type};
+    memcpy(out, &header, sizeof(header));
+    memcpy(out + sizeof(header), args, argsSize);
+    return length;
+}
+
+// Calls X(eventType, argsType, member) for every InputEventType but the
+// compact-only ones, where |member| is the field of BridgeInputEvent's union
+// holding the args. Types without args use NoArgs and |member| none.
+#define ARC_INPUT_BRIDGE_EVENT_TYPES(X)                                                   \
+    X(RESET, NoArgs, none)                                                                \
+    X(POINTER_ENTER, PointerArgs, pointer)                                                \
+    X(POINTER_MOVE, PointerArgs, pointer)                                                 \
+    X(POINTER_MOVE_RELATIVE, RelativePointerArgs, relativePointer)                        \
+    X(POINTER_LEAVE, PointerArgs, pointer)                                                \
+    X(POINTER_BUTTON, ButtonArgs, button)                                                 \
+    X(POINTER_SCROLL_X, PointerArgs, pointer)                                             \
+    X(POINTER_SCROLL_Y, PointerArgs, pointer)                                             \
+    X(POINTER_SCROLL_DISCRETE, PointerArgs, pointer)                                      \
+    X(POINTER_SCROLL_STOP, PointerArgs, pointer)                                          \
+    X(POINTER_FRAME, PointerArgs, pointer)                                                \
+    X(TOUCH_DOWN, TouchArgs, touch)                                                       \
+    X(TOUCH_MOVE, TouchArgs, touch)                                                       \
+    X(TOUCH_UP, TouchArgs, touch)                                                         \
+    X(TOUCH_CANCEL, TouchArgs, touch)                                                     \
+    X(TOUCH_SHAPE, TouchArgs, touch)                                                      \
+    X(TOUCH_TOOL_TYPE, TouchArgs, touch)                                                  \
+    X(TOUCH_FORCE, TouchArgs, touch)                                                      \
+    X(TOUCH_TILT, TouchArgs, touch)                                                       \
+    X(TOUCH_FRAME, TouchArgs, touch)                                                      \
+    X(GESTURE_PINCH_BEGIN, GestureArgs, gesture)                                          \
+    X(GESTURE_PINCH_UPDATE, GesturePinchArgs, gesture_pinch)                              \
+    X(GESTURE_PINCH_END, GestureArgs, gesture)                                            \
+    X(GESTURE_SWIPE_BEGIN, GestureArgs, gesture)                                          \
+    X(GESTURE_SWIPE_UPDATE, GestureSwipeArgs, gesture_swipe)                              \
+    X(GESTURE_SWIPE_END, GestureArgs, gesture)                                            \
+    X(KEY, KeyArgs, key)                                                                  \
+    X(KEY_MODIFIERS, MetaArgs, meta)                                                      \
+    X(KEY_RESET, NoArgs, none)                                                            \
+    X(GAMEPAD_CONNECTED, GamepadDeviceInfoArgs, gamepad_device_info)                      \
+    X(GAMEPAD_DISCONNECTED, GamepadArgs, gamepad)                                         \
+    X(GAMEPAD_AXIS_INFO, GamepadAxisInfoArgs, gamepad_axis_info)                          \
+    X(GAMEPAD_ACTIVATED, GamepadArgs, gamepad)                                            \
+    X(GAMEPAD_AXIS, GamepadArgs, gamepad)                                                 \
+    X(GAMEPAD_BUTTON, GamepadArgs, gamepad)                                               \
+    X(GAMEPAD_FRAME, GamepadArgs, gamepad)                                                \
+    X(SWITCH, SwitchArgs, switches)                                                       \
+    X(DISPLAY_METRICS, DisplayMetricsArgs, display_metrics)                               \
+    X(KEY_CHARACTER_MAP_NAME, KeyCharacterMapNameArgs, key_character_map_name)            \
+    X(WIRE_FORMAT, WireFormatArgs, wire_format)                                           \
+    X(FRAME_BATCH, FrameBatchArgs, frame_batch)                                           \
+    X(GAMEPAD_CONNECTED_REF, GamepadDeviceRefArgs, gamepad_device_ref)                    \
+    X(KEY_CHARACTER_MAP_NAME_REF, KeyCharacterMapNameRefArgs, key_character_map_name_ref) \
+    X(GAMEPAD_SNAPSHOT, GamepadSnapshotArgs, gamepad_snapshot)                            \
+    X(CLOCK_SYNC, ClockSyncArgs, clock_sync)
+
 }  // namespace arc
 
 #endif  // _RUNTIME_ARC_INPUT_BRIDGE_PROTOCOL_H
@@ -0,0 +1,459 @@
+/*
+ * Copyright 2026 The Chromium Authors.
+ *
+ * Permission is hereby granted, free of charge, to any person obtaining a
+ * copy of this software and associated documentation files (the "Software"),
+ * to deal in the Software without restriction, including without limitation
+ * the rights to use, copy, modify, merge, publish, distribute, sublicense,
+ * and/or sell copies of the Software, and to permit persons to whom the
+ * Software is furnished to do so, subject to the following conditions:
+ *
+ * The above copyright notice and this permission notice (including the next
+ * paragraph) shall be included in all copies or substantial portions of the
+ * Software.
+ *
+ * THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+ * IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+ * FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL
+ * THE AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+ * LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING
+ * FROM, OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER
+ * DEALINGS IN THE SOFTWARE.
+ */
+#ifndef _RUNTIME_ARC_INPUT_BRIDGE_RING_H
+#define _RUNTIME_ARC_INPUT_BRIDGE_RING_H
+
+#include <fcntl.h>
+#include <poll.h>
+#include <sys/eventfd.h>
+#include <sys/mman.h>
+#include <sys/socket.h>
+#include <sys/stat.h>
+#include <sys/un.h>
+#include <unistd.h>
+
+#include <atomic>
+#include <cerrno>
+#include <cstddef>
+#include <cstdint>
+#include <cstring>
+#include <new>
+
+#include "ArcInputBridgeProtocol.h"
+
+namespace arc {
+
+// Location of the unix socket the consumer listens on to receive the shared
+// memory ring from the producer. If the producer can't hand over a ring it
+// falls back to writing BridgeInputEvents to kArcInputBridgePipe.
+static const char* kArcInputBridgeRingSocket = "/var/run/inputbridge/inputbridge_ring";
+
+static constexpr uint32_t kArcInputBridgeRingMagic = 0x41524942;  // "ARIB"
+static constexpr uint32_t kArcInputBridgeRingVersion = 1;
+// Must be a power of two.
+static constexpr uint32_t kArcInputBridgeRingDefaultCapacity = 1024;
+// Largest ring a consumer maps. The capacity comes from the producer, so it
+// is bounded before it sizes a mapping.
+static constexpr uint32_t kArcInputBridgeRingMaxCapacity = 65536;
+// Seals the producer must have placed on the memfd. They guarantee the file
+// can't be truncated under the consumer's mapping, which would otherwise
+// SIGBUS the consumer on its next slot access.
+static constexpr int kArcInputBridgeRingSeals = F_SEAL_SHRINK | F_SEAL_GROW | F_SEAL_SEAL;
+
+// Header placed at the start of the shared memory region. The slots follow at
+// offset sizeof(BridgeInputRingHeader).
+//
+// |head| and |tail| are free running counters; a slot index is obtained by
+// masking with capacity - 1. The producer only ever writes |tail| and the
+// consumer only ever writes |head|, so the ring is single-producer,
+// single-consumer and lock-free. Both counters live on their own cache line so
+// the two sides don't false-share.
+struct BridgeInputRingHeader {
+    uint32_t magic;
+    uint32_t version;
+    uint32_t capacity;
+    uint32_t slotSize;
+    alignas(64) std::atomic<uint32_t> head;
+    alignas(64) std::atomic<uint32_t> tail;
+};
+
+static_assert(std::atomic<uint32_t>::is_always_lock_free,
+              "the ring requires lock-free atomics to be shared across processes");
+
+static inline size_t BridgeInputRingSize(uint32_t capacity) {
+    return sizeof(BridgeInputRingHeader) + size_t{capacity} * sizeof(BridgeInputEvent);
+}
+
+static inline bool BridgeInputRingIsValidCapacity(uint32_t capacity) {
+    return capacity != 0 && (capacity & (capacity - 1)) == 0 &&
+            capacity <= kArcInputBridgeRingMaxCapacity;
+}
+
+static inline BridgeInputEvent* BridgeInputRingSlots(BridgeInputRingHeader* header) {
+    return reinterpret_cast<BridgeInputEvent*>(header + 1);
+}
+
+// Producer side of the ring. Owns the memfd backing the ring and the eventfd
+// used as a doorbell.
+//
+// The doorbell is only rung when an event is written into an empty ring, so a
+// consumer that is already draining the ring is never woken up again and a
+// burst of events costs a single eventfd write.
+class BridgeInputRingWriter {
+public:
+    BridgeInputRingWriter() = default;
+    ~BridgeInputRingWriter() { Close(); }
+
+    BridgeInputRingWriter(const BridgeInputRingWriter&) = delete;
+    BridgeInputRingWriter& operator=(const BridgeInputRingWriter&) = delete;
+
+    // Creates the ring. |capacity| must be a power of two no larger than
+    // kArcInputBridgeRingMaxCapacity. Returns false if the
+    // ring couldn't be created, in which case the caller should keep using
+    // kArcInputBridgePipe.
+    bool Create(uint32_t capacity = kArcInputBridgeRingDefaultCapacity) {
+        Close();
+        if (!BridgeInputRingIsValidCapacity(capacity)) {
+            return false;
+        }
+        size_t size = BridgeInputRingSize(capacity);
+        mMemFd = memfd_create("inputbridge_ring", MFD_CLOEXEC | MFD_ALLOW_SEALING);
+        if (mMemFd < 0 || ftruncate(mMemFd, size) != 0 ||
+            fcntl(mMemFd, F_ADD_SEALS, kArcInputBridgeRingSeals) != 0) {
+            Close();
+            return false;
+        }
+        void* addr = mmap(nullptr, size, PROT_READ | PROT_WRITE, MAP_SHARED, mMemFd, 0);
+        if (addr == MAP_FAILED) {
+            Close();
+            return false;
+        }
+        mEventFd = eventfd(0, EFD_CLOEXEC | EFD_NONBLOCK);
+        if (mEventFd < 0) {
+            munmap(addr, size);
+            Close();
+            return false;
+        }
+        mHeader = new (addr) BridgeInputRingHeader{kArcInputBridgeRingMagic,
+                                                   kArcInputBridgeRingVersion,
+                                                   capacity,
+                                                   sizeof(BridgeInputEvent),
+                                                   {0},
+                                                   {0}};
+        mSlots = BridgeInputRingSlots(mHeader);
+        mTail = 0;
+        return true;
+    }
+
+    void Close() {
+        if (mHeader != nullptr) {
+            munmap(mHeader, BridgeInputRingSize(mHeader->capacity));
+            mHeader = nullptr;
+            mSlots = nullptr;
+        }
+        if (mMemFd >= 0) {
+            close(mMemFd);
+            mMemFd = -1;
+        }
+        if (mEventFd >= 0) {
+            close(mEventFd);
+            mEventFd = -1;
+        }
+    }
+
+    bool IsValid() const { return mHeader != nullptr; }
+    int memFd() const { return mMemFd; }
+    int eventFd() const { return mEventFd; }
+
+    // Hands the memfd and eventfd over to the consumer listening on
+    // |socketPath| using SCM_RIGHTS.
+    bool SendToConsumer(const char* socketPath = kArcInputBridgeRingSocket) const {
+        if (!IsValid()) {
+            return false;
+        }
+        int sock = socket(AF_UNIX, SOCK_STREAM | SOCK_CLOEXEC, 0);
+        if (sock < 0) {
+            return false;
+        }
+        sockaddr_un addr{};
+        addr.sun_family = AF_UNIX;
+        strncpy(addr.sun_path, socketPath, sizeof(addr.sun_path) - 1);
+        bool ok = connect(sock, reinterpret_cast<sockaddr*>(&addr), sizeof(addr)) == 0;
+        if (ok) {
+            int fds[2] = {mMemFd, mEventFd};
+            uint8_t version = kArcInputBridgeRingVersion;
+            iovec iov{&version, sizeof(version)};
+            alignas(cmsghdr) char control[CMSG_SPACE(sizeof(fds))] = {};
+            msghdr msg{};
+            msg.msg_iov = &iov;
+            msg.msg_iovlen = 1;
+            msg.msg_control = control;
+            msg.msg_controllen = sizeof(control);
+            cmsghdr* cmsg = CMSG_FIRSTHDR(&msg);
+            cmsg->cmsg_level = SOL_SOCKET;
+            cmsg->cmsg_type = SCM_RIGHTS;
+            cmsg->cmsg_len = CMSG_LEN(sizeof(fds));
+            memcpy(CMSG_DATA(cmsg), fds, sizeof(fds));
+            ok = TEMP_FAILURE_RETRY(sendmsg(sock, &msg, MSG_NOSIGNAL)) == sizeof(version);
+        }
+        close(sock);
+        return ok;
+    }
+
+    // Copies |event| into the ring. Returns false without blocking if the ring
+    // is full.
+    bool Write(const BridgeInputEvent& event) {
+        uint32_t head = mHeader->head.load(std::memory_order_acquire);
+        if (mTail - head == mHeader->capacity) {
+            return false;
+        }
+        mSlots[mTail & (mHeader->capacity - 1)] = event;
+        mTail++;
+        // The tail store and the head load below pair with the consumer's head
+        // store and tail load in BridgeInputRingReader::Read. Sequential
+        // consistency guarantees that either we observe the consumer having
+        // drained the ring and ring the doorbell, or the consumer observes the
+        // new tail before it goes to sleep.
+        mHeader->tail.store(mTail, std::memory_order_seq_cst);
+        if (mHeader->head.load(std::memory_order_seq_cst) == mTail - 1) {
+            uint64_t one = 1;
+            TEMP_FAILURE_RETRY(write(mEventFd, &one, sizeof(one)));
+        }
+        return true;
+    }
+
+private:
+    BridgeInputRingHeader* mHeader = nullptr;
+    BridgeInputEvent* mSlots = nullptr;
+    uint32_t mTail = 0;
+    int mMemFd = -1;
+    int mEventFd = -1;
+};
+
+// Consumer side of the ring.
+class BridgeInputRingReader {
+public:
+    BridgeInputRingReader() = default;
+    ~BridgeInputRingReader() { Close(); }
+
+    BridgeInputRingReader(const BridgeInputRingReader&) = delete;
+    BridgeInputRingReader& operator=(const BridgeInputRingReader&) = delete;
+
+    // Creates the socket on which BridgeInputRingWriter::SendToConsumer
+    // connects. Returns the listening fd, or -1 on failure.
+    static int Listen(const char* socketPath = kArcInputBridgeRingSocket) {
+        int sock = socket(AF_UNIX, SOCK_STREAM | SOCK_CLOEXEC, 0);
+        if (sock < 0) {
+            return -1;
+        }
+        sockaddr_un addr{};
+        addr.sun_family = AF_UNIX;
+        strncpy(addr.sun_path, socketPath, sizeof(addr.sun_path) - 1);
+        unlink(socketPath);
+        if (bind(sock, reinterpret_cast<sockaddr*>(&addr), sizeof(addr)) != 0 ||
+            listen(sock, 1) != 0) {
+            close(sock);
+            return -1;
+        }
+        return sock;
+    }
+
+    // Accepts a producer on |listenFd| and attaches to the ring it sends.
+    bool Accept(int listenFd) {
+        int conn = TEMP_FAILURE_RETRY(accept4(listenFd, nullptr, nullptr, SOCK_CLOEXEC));
+        if (conn < 0) {
+            return false;
+        }
+        int fds[2] = {-1, -1};
+        uint8_t version = 0;
+        iovec iov{&version, sizeof(version)};
+        alignas(cmsghdr) char control[CMSG_SPACE(sizeof(fds))] = {};
+        msghdr msg{};
+        msg.msg_iov = &iov;
+        msg.msg_iovlen = 1;
+        msg.msg_control = control;
+        msg.msg_controllen = sizeof(control);
+        ssize_t n = TEMP_FAILURE_RETRY(recvmsg(conn, &msg, MSG_CMSG_CLOEXEC));
+        close(conn);
+        if (n < 0) {
+            return false;
+        }
+        cmsghdr* cmsg = CMSG_FIRSTHDR(&msg);
+        if (n != sizeof(version) || (msg.msg_flags & MSG_CTRUNC) || cmsg == nullptr ||
+            cmsg->cmsg_level != SOL_SOCKET || cmsg->cmsg_type != SCM_RIGHTS ||
+            cmsg->cmsg_len != CMSG_LEN(sizeof(fds))) {
+            CloseReceivedFds(&msg);
+            return false;
+        }
+        memcpy(fds, CMSG_DATA(cmsg), sizeof(fds));
+        if (version != kArcInputBridgeRingVersion || !Attach(fds[0], fds[1])) {
+            close(fds[0]);
+            close(fds[1]);
+            return false;
+        }
+        return true;
+    }
+
+    // Maps the ring backed by |memFd|. On success the reader takes ownership of
+    // both file descriptors.
+    //
+    // The producer isn't trusted: the memfd must carry kArcInputBridgeRingSeals
+    // and be at least as large as the capacity in its header implies, and the
+    // capacity must be one BridgeInputRingWriter::Create would accept.
+    bool Attach(int memFd, int eventFd) {
+        Close();
+        BridgeInputRingHeader probe;
+        struct stat st;
+        int seals = fcntl(memFd, F_GET_SEALS);
+        if (seals < 0 || (seals & kArcInputBridgeRingSeals) != kArcInputBridgeRingSeals ||
+            TEMP_FAILURE_RETRY(pread(memFd, &probe, offsetof(BridgeInputRingHeader, head), 0)) !=
+                    static_cast<ssize_t>(offsetof(BridgeInputRingHeader, head)) ||
+            probe.magic != kArcInputBridgeRingMagic ||
+            probe.version != kArcInputBridgeRingVersion ||
+            probe.slotSize != sizeof(BridgeInputEvent) ||
+            !BridgeInputRingIsValidCapacity(probe.capacity) ||
+            fstat(memFd, &st) != 0 || st.st_size < 0 ||
+            static_cast<uint64_t>(st.st_size) < BridgeInputRingSize(probe.capacity)) {
+            return false;
+        }
+        void* addr = mmap(nullptr, BridgeInputRingSize(probe.capacity), PROT_READ | PROT_WRITE,
+                          MAP_SHARED, memFd, 0);
+        if (addr == MAP_FAILED) {
+            return false;
+        }
+        mHeader = static_cast<BridgeInputRingHeader*>(addr);
+        mCapacity = probe.capacity;
+        mSlots = BridgeInputRingSlots(mHeader);
+        mHead = mHeader->head.load(std::memory_order_relaxed);
+        mMemFd = memFd;
+        mEventFd = eventFd;
+        return true;
+    }
+
+    void Close() {
+        if (mHeader != nullptr) {
+            munmap(mHeader, BridgeInputRingSize(mCapacity));
+            mHeader = nullptr;
+            mSlots = nullptr;
+        }
+        if (mMemFd >= 0) {
+            close(mMemFd);
+            mMemFd = -1;
+        }
+        if (mEventFd >= 0) {
+            close(mEventFd);
+            mEventFd = -1;
+        }
+    }
+
+    bool IsValid() const { return mHeader != nullptr; }
+    // Becomes readable when the producer writes into an empty ring. Suitable
+    // for use with poll/epoll.
+    int eventFd() const { return mEventFd; }
+
+    // Pops the oldest event into |outEvent|. Returns false if the ring is empty.
+    bool Read(BridgeInputEvent* outEvent) {
+        uint32_t tail = mHeader->tail.load(std::memory_order_acquire);
+        if (tail == mHead) {
+            return false;
+        }
+        *outEvent = mSlots[mHead & (mCapacity - 1)];
+        mHead++;
+        mHeader->head.store(mHead, std::memory_order_seq_cst);
+        return true;
+    }
+
+    // Blocks until the ring is non-empty or |timeoutMs| expires. A negative
+    // timeout waits forever. Returns true if there is at least one event to
+    // read.
+    bool Wait(int timeoutMs = -1) {
+        for (;;) {
+            // Re-check after every wakeup; the doorbell may be stale, and a
+            // write racing with the last Read() may not have rung it.
+            if (mHeader->tail.load(std::memory_order_seq_cst) != mHead) {
+                return true;
+            }
+            pollfd pfd{mEventFd, POLLIN, 0};
+            int ret = TEMP_FAILURE_RETRY(poll(&pfd, 1, timeoutMs));
+            if (ret <= 0) {
+                return false;
+            }
+            uint64_t count;
+            TEMP_FAILURE_RETRY(read(mEventFd, &count, sizeof(count)));
+        }
+    }
+
+private:
+    // Closes every descriptor passed in |msg|, so that a malformed message
+    // doesn't leak them.
+    static void CloseReceivedFds(msghdr* msg) {
+        for (cmsghdr* cmsg = CMSG_FIRSTHDR(msg); cmsg != nullptr; cmsg = CMSG_NXTHDR(msg, cmsg)) {
+            if (cmsg->cmsg_level != SOL_SOCKET || cmsg->cmsg_type != SCM_RIGHTS ||
+                cmsg->cmsg_len < CMSG_LEN(0)) {
+                continue;
+            }
+            size_t count = (cmsg->cmsg_len - CMSG_LEN(0)) / sizeof(int);
+            for (size_t i = 0; i < count; i++) {
+                int fd;
+                memcpy(&fd, CMSG_DATA(cmsg) + i * sizeof(int), sizeof(fd));
+                close(fd);
+            }
+        }
+    }
+
+    BridgeInputRingHeader* mHeader = nullptr;
+    BridgeInputEvent* mSlots = nullptr;
+    uint32_t mCapacity = 0;
+    uint32_t mHead = 0;
+    int mMemFd = -1;
+    int mEventFd = -1;
+};
+
+// Convenience writer used by producers. Prefers the shared memory ring and
+// falls back to kArcInputBridgePipe if the consumer doesn't accept a ring.
+class BridgeInputEventWriter {
+public:
+    BridgeInputEventWriter() = default;
+    ~BridgeInputEventWriter() { Close(); }
+
+    BridgeInputEventWriter(const BridgeInputEventWriter&) = delete;
+    BridgeInputEventWriter& operator=(const BridgeInputEventWriter&) = delete;
+
+    bool Open(const char* socketPath = kArcInputBridgeRingSocket,
+              const char* pipePath = kArcInputBridgePipe) {
+        Close();
+        if (mRing.Create() && mRing.SendToConsumer(socketPath)) {
+            return true;
+        }
+        mRing.Close();
+        mPipeFd = TEMP_FAILURE_RETRY(open(pipePath, O_WRONLY | O_CLOEXEC));
+        return mPipeFd >= 0;
+    }
+
+    void Close() {
+        mRing.Close();
+        if (mPipeFd >= 0) {
+            close(mPipeFd);
+            mPipeFd = -1;
+        }
+    }
+
+    bool IsUsingRing() const { return mRing.IsValid(); }
+
+    // Returns false if the event could not be delivered, e.g. because the ring
+    // is full or the pipe was closed.
+    bool Write(const BridgeInputEvent& event) {
+        if (mRing.IsValid()) {
+            return mRing.Write(event);
+        }
+        return TEMP_FAILURE_RETRY(write(mPipeFd, &event, sizeof(event))) == sizeof(event);
+    }
+
+private:
+    BridgeInputRingWriter mRing;
+    int mPipeFd = -1;
+};
+
+}  // namespace arc
+
+#endif  // _RUNTIME_ARC_INPUT_BRIDGE_RING_H
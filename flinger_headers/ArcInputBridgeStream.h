@@ -0,0 +1,260 @@
+/*
+ * Copyright 2026 The Chromium Authors.
+ *
+ * Permission is hereby granted, free of charge, to any person obtaining a
+ * copy of this software and associated documentation files (the "Software"),
+ * to deal in the Software without restriction, including without limitation
+ * the rights to use, copy, modify, merge, publish, distribute, sublicense,
+ * and/or sell copies of the Software, and to permit persons to whom the
+ * Software is furnished to do so, subject to the following conditions:
+ *
+ * The above copyright notice and this permission notice (including the next
+ * paragraph) shall be included in all copies or substantial portions of the
+ * Software.
+ *
+ * THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+ * IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+ * FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL
+ * THE AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+ * LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING
+ * FROM, OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER
+ * DEALINGS IN THE SOFTWARE.
+ */
+#ifndef _RUNTIME_ARC_INPUT_BRIDGE_STREAM_H
+#define _RUNTIME_ARC_INPUT_BRIDGE_STREAM_H
+
+#include <fcntl.h>
+#include <limits.h>
+#include <stdio.h>
+#include <unistd.h>
+
+#include <cerrno>
+#include <cstddef>
+#include <cstdint>
+#include <cstring>
+#include <string>
+#include <vector>
+
+#include "ArcInputBridgeMetadata.h"
+#include "ArcInputBridgeProtocol.h"
+#include "ArcInputBridgeTouchDelta.h"
+
+namespace arc {
+
+// Wire format negotiation on kArcInputBridgePipe, see
+// kArcInputBridgeWireVersionFile.
+//
+// The pipe only carries data from the producer to the consumer, so the
+// consumer answers out of band: it publishes the highest wire version it
+// decodes before opening the pipe, and the producer reads it back once its
+// own open() has returned. The file lives next to the pipe on tmpfs, so it
+// doesn't outlive the consumer that wrote it across a reboot.
+
+// Consumer side. Publishes |version| in |path|. Call it before opening
+// kArcInputBridgePipe for reading. The file is replaced atomically, so a
+// producer never reads a partial one.
+static inline bool BridgeInputPublishWireVersion(
+        uint8_t version = kArcInputBridgeWireVersionCompact,
+        const char* path = kArcInputBridgeWireVersionFile) {
+    std::string temp = std::string(path) + ".tmp";
+    int fd = TEMP_FAILURE_RETRY(open(temp.c_str(), O_WRONLY | O_CREAT | O_TRUNC | O_CLOEXEC, 0644));
+    if (fd < 0) {
+        return false;
+    }
+    bool ok = TEMP_FAILURE_RETRY(write(fd, &version, sizeof(version))) == sizeof(version);
+    ok = close(fd) == 0 && ok;
+    if (!ok || rename(temp.c_str(), path) != 0) {
+        unlink(temp.c_str());
+        return false;
+    }
+    return true;
+}
+
+// Consumer side. Call it when closing kArcInputBridgePipe, so that whatever
+// opens the pipe next starts from the legacy format.
+static inline void BridgeInputWithdrawWireVersion(
+        const char* path = kArcInputBridgeWireVersionFile) {
+    unlink(path);
+}
+
+// Producer side. Returns the highest wire version the consumer decodes, or
+// kArcInputBridgeWireVersionLegacy if it didn't publish one. Call it after
+// every successful open() of kArcInputBridgePipe, since the consumer may have
+// changed, and only send WIRE_FORMAT for a version up to the one returned.
+static inline uint8_t BridgeInputConsumerWireVersion(
+        const char* path = kArcInputBridgeWireVersionFile) {
+    int fd = TEMP_FAILURE_RETRY(open(path, O_RDONLY | O_CLOEXEC));
+    if (fd < 0) {
+        return kArcInputBridgeWireVersionLegacy;
+    }
+    uint8_t version;
+    if (TEMP_FAILURE_RETRY(read(fd, &version, sizeof(version))) != sizeof(version)) {
+        version = kArcInputBridgeWireVersionLegacy;
+    }
+    close(fd);
+    return version;
+}
+
+// Consumer side decoder for the byte stream of kArcInputBridgePipe. It starts
+// in the legacy format and follows WIRE_FORMAT events, which it consumes
+// rather than hands out. All the bundled readers decode through it, so they
+// never assume a record size.
+//
+// It also consumes the compact-only records: METADATA goes into a
+// BridgeInputMetadataTable, through which *_REF events are expanded into
+// their legacy counterparts, and TOUCH_DELTA_FRAME is expanded into the
+// events it stands for.
+//
+// A compact stream has no sync points: once a record can't be decoded,
+// corrupt() becomes true and Next() stops returning events. The consumer
+// should then close the pipe and let the producer reconnect.
+class BridgeInputStreamDecoder {
+public:
+    BridgeInputStreamDecoder() = default;
+
+    BridgeInputStreamDecoder(const BridgeInputStreamDecoder&) = delete;
+    BridgeInputStreamDecoder& operator=(const BridgeInputStreamDecoder&) = delete;
+
+    // Performs a single read() from |fd| into the buffer. Returns the number
+    // of bytes read, 0 on EOF or -1 on error (errno is set, EAGAIN included
+    // for non-blocking fds). Fails with ENOBUFS if the buffer is full, i.e.
+    // buffered events weren't drained with Next().
+    ssize_t Fill(int fd) {
+        Compact();
+        if (mEnd == sizeof(mBuffer)) {
+            errno = ENOBUFS;
+            return -1;
+        }
+        ssize_t n = TEMP_FAILURE_RETRY(read(fd, mBuffer + mEnd, sizeof(mBuffer) - mEnd));
+        if (n > 0) {
+            mEnd += n;
+        }
+        return n;
+    }
+
+    // Appends stream bytes that were received some other way. Returns how
+    // many fit.
+    size_t Append(const uint8_t* data, size_t size) {
+        Compact();
+        size_t room = sizeof(mBuffer) - mEnd;
+        if (size > room) {
+            size = room;
+        }
+        memcpy(mBuffer + mEnd, data, size);
+        mEnd += size;
+        return size;
+    }
+
+    // Decodes the next whole event into |outEvent|. Returns false if none is
+    // buffered.
+    bool Next(BridgeInputEvent* outEvent) {
+        while (!mCorrupt) {
+            if (mExpandedIndex < mExpanded.size()) {
+                *outEvent = mExpanded[mExpandedIndex++];
+                return true;
+            }
+            const uint8_t* in = mBuffer + mBegin;
+            size_t size = mEnd - mBegin;
+            size_t consumed;
+            if (mWireVersion == kArcInputBridgeWireVersionLegacy) {
+                if (size < sizeof(BridgeInputEvent)) {
+                    return false;
+                }
+                memcpy(outEvent, in, sizeof(BridgeInputEvent));
+                consumed = sizeof(BridgeInputEvent);
+            } else {
+                consumed = BridgeInputEvent::DecodeCompact(in, size, outEvent);
+                if (consumed == 0) {
+                    mCorrupt = size >= BridgeInputEvent::kMaxCompactSize;
+                    return false;
+                }
+            }
+            mBegin += consumed;
+            if (IsCompactOnly(outEvent->type)) {
+                // A legacy event can't carry the args, so drop those.
+                if (mWireVersion != kArcInputBridgeWireVersionLegacy) {
+                    size_t argsSize = consumed - sizeof(BridgeInputEventCompactHeader);
+                    Consume(outEvent->type, in + sizeof(BridgeInputEventCompactHeader), argsSize);
+                }
+                continue;
+            }
+            if (outEvent->type == InputEventType::RESET ||
+                outEvent->type == InputEventType::TOUCH_CANCEL) {
+                mTouchDelta.Reset();
+            }
+            if (outEvent->type != InputEventType::WIRE_FORMAT) {
+                mMetadata.Expand(outEvent);
+                return true;
+            }
+            if (outEvent->wire_format.version > kArcInputBridgeWireVersionCompact) {
+                mCorrupt = true;
+            } else {
+                mWireVersion = outEvent->wire_format.version;
+            }
+        }
+        return false;
+    }
+
+    // Forgets the buffered bytes, the metadata and the touch contacts, and
+    // returns to the legacy format, e.g. after reopening the pipe.
+    void Reset() {
+        mBegin = 0;
+        mEnd = 0;
+        mWireVersion = kArcInputBridgeWireVersionLegacy;
+        mCorrupt = false;
+        mMetadata.Reset();
+        mTouchDelta.Reset();
+        mExpanded.clear();
+        mExpandedIndex = 0;
+    }
+
+    uint8_t wireVersion() const { return mWireVersion; }
+    const BridgeInputMetadataTable& metadata() const { return mMetadata; }
+    const BridgeInputTouchDeltaDecoder& touchDelta() const { return mTouchDelta; }
+    bool corrupt() const { return mCorrupt; }
+    // Bytes received but not decoded yet.
+    size_t buffered() const { return mEnd - mBegin; }
+
+private:
+    // Handles the args of a compact-only record.
+    void Consume(InputEventType type, const uint8_t* args, size_t size) {
+        switch (type) {
+            case InputEventType::METADATA:
+                mMetadata.Store(args, size);
+                return;
+            case InputEventType::TOUCH_DELTA_FRAME:
+                mExpanded.clear();
+                mExpandedIndex = 0;
+                mTouchDelta.DecodeRecord(args, size, &mExpanded);
+                return;
+            default:
+                return;
+        }
+    }
+
+    // Moves any partial record to the start of the buffer.
+    void Compact() {
+        if (mBegin == 0) {
+            return;
+        }
+        memmove(mBuffer, mBuffer + mBegin, mEnd - mBegin);
+        mEnd -= mBegin;
+        mBegin = 0;
+    }
+
+    uint8_t mWireVersion = kArcInputBridgeWireVersionLegacy;
+    bool mCorrupt = false;
+    BridgeInputMetadataTable mMetadata;
+    BridgeInputTouchDeltaDecoder mTouchDelta;
+    // Events of the last TOUCH_DELTA_FRAME not handed out yet.
+    std::vector<BridgeInputEvent> mExpanded;
+    size_t mExpandedIndex = 0;
+    size_t mBegin = 0;
+    size_t mEnd = 0;
+    // Several pipe writes' worth, so a single read() drains a typical burst.
+    uint8_t mBuffer[4 * PIPE_BUF];
+};
+
+}  // namespace arc
+
+#endif  // _RUNTIME_ARC_INPUT_BRIDGE_STREAM_H
@@ -0,0 +1,398 @@
+/*
+ * Copyright 2026 The Chromium Authors.
+ *
+ * Permission is hereby granted, free of charge, to any person obtaining a
+ * copy of this software and associated documentation files (the "Software"),
+ * to deal in the Software without restriction, including without limitation
+ * the rights to use, copy, modify, merge, publish, distribute, sublicense,
+ * and/or sell copies of the Software, and to permit persons to whom the
+ * Software is furnished to do so, subject to the following conditions:
+ *
+ * The above copyright notice and this permission notice (including the next
+ * paragraph) shall be included in all copies or substantial portions of the
+ * Software.
+ *
+ * THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+ * IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+ * FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL
+ * THE AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+ * LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING
+ * FROM, OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER
+ * DEALINGS IN THE SOFTWARE.
+ */
+#ifndef _RUNTIME_ARC_INPUT_BRIDGE_TOUCH_DELTA_H
+#define _RUNTIME_ARC_INPUT_BRIDGE_TOUCH_DELTA_H
+
+#include <cmath>
+#include <cstddef>
+#include <cstdint>
+#include <cstring>
+#include <vector>
+
+#include "ArcInputBridgeProtocol.h"
+
+namespace arc {
+
+// Delta encoding of multi-touch TOUCH_MOVE frames.
+//
+// A frame is the TOUCH_MOVE events up to and including a TOUCH_FRAME. Every
+// encoded frame starts with a flags byte:
+//
+//   keyframe: the timestamp, displayId, contact count, then for each contact
+//             its id and its absolute x/y as raw floats. The contact list is
+//             remembered by both sides.
+//   delta:    the timestamp relative to the previous frame's, a bitmask over
+//             the remembered contact list telling which contacts moved, then
+//             for each of them dx/dy relative to the previous decoded
+//             position, quantized to 1/kQuantization px.
+//
+// Integers are zigzag varints. The encoder tracks the positions the decoder
+// will reconstruct, so quantization error never accumulates, and keyframes
+// restore exact values. A keyframe is sent when the contact list or display
+// changes, when a delta is too large, and at least every kKeyframeInterval
+// frames.
+//
+// Frames containing anything but TOUCH_MOVE are not encodable and must be
+// sent as regular events; the encoder and decoder don't need to see them.
+// All moves of an encoded frame get the TOUCH_FRAME's timestamp.
+//
+// On the compact wire format a frame travels as a TOUCH_DELTA_FRAME record,
+// see EncodeRecord(), which BridgeInputStreamDecoder expands back into
+// events. The stream decoder resets its delta decoder on RESET and
+// TOUCH_CANCEL, so the producer must request a keyframe after sending either.
+static constexpr float kTouchDeltaQuantization = 16.0f;
+static constexpr uint32_t kTouchDeltaKeyframeInterval = 60;
+static constexpr uint32_t kTouchDeltaMaxContacts = 32;
+
+// Most contacts a TOUCH_DELTA_FRAME record holds. A keyframe takes at most 17
+// bytes plus 13 per contact, and has to fit in the args of a compact record.
+static constexpr uint32_t kTouchDeltaMaxRecordContacts =
+        (sizeof(BridgeInputEvent) - offsetof(BridgeInputEvent, pointer) - 17) / 13;
+
+namespace touch_delta {
+
+static constexpr uint8_t kFlagKeyframe = 1;
+
+static inline void PutVarint(uint64_t value, std::vector<uint8_t>* out) {
+    while (value >= 0x80) {
+        out->push_back(static_cast<uint8_t>(value) | 0x80);
+        value >>= 7;
+    }
+    out->push_back(static_cast<uint8_t>(value));
+}
+
+static inline void PutSigned(int64_t value, std::vector<uint8_t>* out) {
+    PutVarint((static_cast<uint64_t>(value) << 1) ^ static_cast<uint64_t>(value >> 63), out);
+}
+
+static inline void PutFloat(float value, std::vector<uint8_t>* out) {
+    uint8_t bytes[sizeof(value)];
+    memcpy(bytes, &value, sizeof(value));
+    out->insert(out->end(), bytes, bytes + sizeof(bytes));
+}
+
+// Minimal bounds-checked reader.
+class Reader {
+public:
+    Reader(const uint8_t* data, size_t size) : mData(data), mSize(size) {}
+
+    bool GetVarint(uint64_t* value) {
+        *value = 0;
+        for (uint32_t shift = 0; shift < 64; shift += 7) {
+            if (mOffset >= mSize) {
+                return false;
+            }
+            uint8_t byte = mData[mOffset++];
+            *value |= uint64_t{byte & 0x7fu} << shift;
+            if (!(byte & 0x80)) {
+                return true;
+            }
+        }
+        return false;
+    }
+
+    bool GetSigned(int64_t* value) {
+        uint64_t raw;
+        if (!GetVarint(&raw)) {
+            return false;
+        }
+        *value = static_cast<int64_t>(raw >> 1) ^ -static_cast<int64_t>(raw & 1);
+        return true;
+    }
+
+    bool GetFloat(float* value) {
+        if (mSize - mOffset < sizeof(*value)) {
+            return false;
+        }
+        memcpy(value, mData + mOffset, sizeof(*value));
+        mOffset += sizeof(*value);
+        return true;
+    }
+
+    bool GetByte(uint8_t* value) {
+        if (mOffset >= mSize) {
+            return false;
+        }
+        *value = mData[mOffset++];
+        return true;
+    }
+
+    size_t offset() const { return mOffset; }
+
+private:
+    const uint8_t* mData;
+    size_t mSize;
+    size_t mOffset = 0;
+};
+
+struct Contact {
+    int32_t id;
+    float x;
+    float y;
+};
+
+}  // namespace touch_delta
+
+class BridgeInputTouchDeltaEncoder {
+public:
+    // Encodes the frame |events[0, count)|, which must be TOUCH_MOVE events
+    // terminated by a TOUCH_FRAME, and appends it to |out|. Returns false,
+    // without writing anything, if the frame can't be delta encoded.
+    bool EncodeFrame(const BridgeInputEvent* events, size_t count, std::vector<uint8_t>* out) {
+        using namespace touch_delta;
+        if (count == 0 || events[count - 1].type != InputEventType::TOUCH_FRAME ||
+            count - 1 > kTouchDeltaMaxContacts) {
+            return false;
+        }
+        const BridgeInputEvent& frame = events[count - 1];
+        for (size_t i = 0; i + 1 < count; i++) {
+            if (events[i].type != InputEventType::TOUCH_MOVE ||
+                events[i].displayId != frame.displayId) {
+                return false;
+            }
+        }
+
+        uint32_t moved = 0;
+        int64_t deltas[kTouchDeltaMaxContacts][2];
+        bool keyframe = !mHasKeyframe || frame.displayId != mDisplayId ||
+                mFramesSinceKeyframe >= kTouchDeltaKeyframeInterval;
+        for (size_t i = 0; i + 1 < count && !keyframe; i++) {
+            int index = IndexOf(events[i].touch.id);
+            if (index < 0 || (moved & (1u << index))) {
+                keyframe = true;
+                break;
+            }
+            moved |= 1u << index;
+            if (!Quantize(events[i].touch.x - mContacts[index].x, &deltas[index][0]) ||
+                !Quantize(events[i].touch.y - mContacts[index].y, &deltas[index][1])) {
+                keyframe = true;
+            }
+        }
+
+        out->push_back(keyframe ? kFlagKeyframe : 0);
+        if (keyframe) {
+            PutVarint(frame.timestamp, out);
+        } else {
+            PutSigned(static_cast<int64_t>(frame.timestamp - mTimestamp), out);
+        }
+        mTimestamp = frame.timestamp;
+
+        if (keyframe) {
+            mHasKeyframe = true;
+            mDisplayId = frame.displayId;
+            mFramesSinceKeyframe = 0;
+            mContacts.clear();
+            PutSigned(frame.displayId, out);
+            PutVarint(count - 1, out);
+            for (size_t i = 0; i + 1 < count; i++) {
+                const TouchArgs& touch = events[i].touch;
+                mContacts.push_back({touch.id, touch.x, touch.y});
+                PutSigned(touch.id, out);
+                PutFloat(touch.x, out);
+                PutFloat(touch.y, out);
+            }
+            return true;
+        }
+
+        mFramesSinceKeyframe++;
+        PutVarint(moved, out);
+        for (uint32_t bits = moved; bits != 0; bits &= bits - 1) {
+            int index = __builtin_ctz(bits);
+            PutSigned(deltas[index][0], out);
+            PutSigned(deltas[index][1], out);
+            // Track what the decoder will reconstruct, not the exact input.
+            mContacts[index].x += deltas[index][0] / kTouchDeltaQuantization;
+            mContacts[index].y += deltas[index][1] / kTouchDeltaQuantization;
+        }
+        return true;
+    }
+
+    // Encodes the frame like EncodeFrame() as a TOUCH_DELTA_FRAME record into
+    // |out|, which must have room for kMaxCompactSize bytes. Returns the size
+    // of the record, or 0 if the frame can't be delta encoded or has more than
+    // kTouchDeltaMaxRecordContacts contacts. The record stands for several
+    // events, so it must not be sent inside a FRAME_BATCH.
+    size_t EncodeRecord(const BridgeInputEvent* events, size_t count, uint8_t* out,
+                        size_t size) {
+        if (size < BridgeInputEvent::kMaxCompactSize || count == 0 ||
+            count - 1 > kTouchDeltaMaxRecordContacts) {
+            return 0;
+        }
+        mRecord.clear();
+        if (!EncodeFrame(events, count, &mRecord)) {
+            return 0;
+        }
+        const BridgeInputEvent& frame = events[count - 1];
+        return BridgeInputEvent::EncodeCompactRecord(frame.timestamp, frame.displayId,
+                                                     InputEventType::TOUCH_DELTA_FRAME,
+                                                     mRecord.data(), mRecord.size(), out, size);
+    }
+
+    // Forces the next frame to be a keyframe, e.g. after touches went down or
+    // up or the stream was reset.
+    void RequestKeyframe() { mHasKeyframe = false; }
+
+private:
+    int IndexOf(int32_t id) const {
+        for (size_t i = 0; i < mContacts.size(); i++) {
+            if (mContacts[i].id == id) {
+                return i;
+            }
+        }
+        return -1;
+    }
+
+    // Deltas this large mean something jumped; a keyframe is cheaper and exact.
+    static bool Quantize(float delta, int64_t* out) {
+        float scaled = std::round(delta * kTouchDeltaQuantization);
+        if (!(std::fabs(scaled) < float{1 << 20})) {
+            return false;
+        }
+        *out = static_cast<int64_t>(scaled);
+        return true;
+    }
+
+    bool mHasKeyframe = false;
+    int32_t mDisplayId = 0;
+    uint64_t mTimestamp = 0;
+    uint32_t mFramesSinceKeyframe = 0;
+    std::vector<touch_delta::Contact> mContacts;
+    std::vector<uint8_t> mRecord;
+};
+
+class BridgeInputTouchDeltaDecoder {
+public:
+    // Decodes one frame from |data| and appends its TOUCH_MOVE events and
+    // TOUCH_FRAME to |out|. Returns the number of bytes consumed, or 0 if the
+    // data is truncated or malformed.
+    size_t DecodeFrame(const uint8_t* data, size_t size, std::vector<BridgeInputEvent>* out) {
+        using namespace touch_delta;
+        Reader reader(data, size);
+        uint8_t flags;
+        if (!reader.GetByte(&flags)) {
+            return 0;
+        }
+        uint64_t timestamp;
+        if (flags & kFlagKeyframe) {
+            if (!reader.GetVarint(&timestamp)) {
+                return 0;
+            }
+        } else {
+            int64_t timestampDelta;
+            if (!reader.GetSigned(&timestampDelta)) {
+                return 0;
+            }
+            timestamp = mTimestamp + static_cast<uint64_t>(timestampDelta);
+        }
+
+        size_t first = out->size();
+        if (flags & kFlagKeyframe) {
+            int64_t displayId;
+            uint64_t count;
+            if (!reader.GetSigned(&displayId) || !reader.GetVarint(&count) ||
+                count > kTouchDeltaMaxContacts) {
+                return 0;
+            }
+            std::vector<Contact> contacts(count);
+            for (Contact& contact : contacts) {
+                int64_t id;
+                if (!reader.GetSigned(&id) || !reader.GetFloat(&contact.x) ||
+                    !reader.GetFloat(&contact.y)) {
+                    return 0;
+                }
+                contact.id = static_cast<int32_t>(id);
+            }
+            mContacts.swap(contacts);
+            mDisplayId = static_cast<int32_t>(displayId);
+            mHasKeyframe = true;
+            for (const Contact& contact : mContacts) {
+                out->push_back(MakeMove(timestamp, contact));
+            }
+        } else {
+            uint64_t moved;
+            if (!mHasKeyframe || !reader.GetVarint(&moved) || (moved >> mContacts.size()) != 0) {
+                return 0;
+            }
+            std::vector<Contact> contacts = mContacts;
+            for (uint64_t bits = moved; bits != 0; bits &= bits - 1) {
+                Contact& contact = contacts[__builtin_ctzll(bits)];
+                int64_t dx;
+                int64_t dy;
+                if (!reader.GetSigned(&dx) || !reader.GetSigned(&dy)) {
+                    out->resize(first);
+                    return 0;
+                }
+                contact.x += dx / kTouchDeltaQuantization;
+                contact.y += dy / kTouchDeltaQuantization;
+                out->push_back(MakeMove(timestamp, contact));
+            }
+            mContacts.swap(contacts);
+        }
+
+        BridgeInputEvent frame{timestamp, mDisplayId, InputEventType::TOUCH_FRAME, {}};
+        out->push_back(frame);
+        mTimestamp = timestamp;
+        return reader.offset();
+    }
+
+    // Decodes the args of a TOUCH_DELTA_FRAME record like DecodeFrame().
+    // Malformed frames are counted in rejectedFrames() and reset the decoder,
+    // so deltas are dropped until the next keyframe.
+    bool DecodeRecord(const uint8_t* args, size_t size, std::vector<BridgeInputEvent>* out) {
+        if (DecodeFrame(args, size, out) != 0) {
+            return true;
+        }
+        Reset();
+        mRejectedFrames++;
+        return false;
+    }
+
+    // Forgets the contact list, so that deltas are dropped until the next
+    // keyframe. Keyframes carry absolute values, so that is all it takes to
+    // resynchronize.
+    void Reset() {
+        mHasKeyframe = false;
+        mContacts.clear();
+    }
+
+    uint64_t rejectedFrames() const { return mRejectedFrames; }
+
+private:
+    BridgeInputEvent MakeMove(uint64_t timestamp, const touch_delta::Contact& contact) const {
+        BridgeInputEvent event{timestamp, mDisplayId, InputEventType::TOUCH_MOVE, {}};
+        event.touch.id = contact.id;
+        event.touch.x = contact.x;
+        event.touch.y = contact.y;
+        return event;
+    }
+
+    bool mHasKeyframe = false;
+    int32_t mDisplayId = 0;
+    uint64_t mTimestamp = 0;
+    std::vector<touch_delta::Contact> mContacts;
+    uint64_t mRejectedFrames = 0;
+};
+
+}  // namespace arc
+
+#endif  // _RUNTIME_ARC_INPUT_BRIDGE_TOUCH_DELTA_H
@@ -0,0 +1,372 @@
+/*
+ * Copyright 2026 The Chromium Authors.
+ *
+ * Permission is hereby granted, free of charge, to any person obtaining a
+ * copy of this software and associated documentation files (the "Software"),
+ * to deal in the Software without restriction, including without limitation
+ * the rights to use, copy, modify, merge, publish, distribute, sublicense,
+ * and/or sell copies of the Software, and to permit persons to whom the
+ * Software is furnished to do so, subject to the following conditions:
+ *
+ * The above copyright notice and this permission notice (including the next
+ * paragraph) shall be included in all copies or substantial portions of the
+ * Software.
+ *
+ * THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+ * IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+ * FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL
+ * THE AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+ * LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING
+ * FROM, OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER
+ * DEALINGS IN THE SOFTWARE.
+ */
+#ifndef _RUNTIME_ARC_INPUT_BRIDGE_VALIDATOR_H
+#define _RUNTIME_ARC_INPUT_BRIDGE_VALIDATOR_H
+
+#include <cmath>
+#include <cstddef>
+#include <cstdint>
+#include <cstring>
+
+#include "ArcInputBridgeFrameBatch.h"
+#include "ArcInputBridgeProtocol.h"
+
+namespace arc {
+
+// Highest evdev axis index plus one, see ABS_CNT in linux/input.h.
+static constexpr uint32_t kArcInputBridgeAxisCount = 0x40;
+
+enum class BridgeInputEventError {
+    NONE = 0,
+    // The type is not a known InputEventType, or one that a BridgeInputEvent
+    // can't hold, see IsCompactOnly().
+    UNKNOWN_TYPE,
+    // A bool field holds something other than 0 or 1. Loading such a bool is
+    // undefined behavior, so the check looks at the raw byte.
+    INVALID_BOOL,
+    // An enum or state field holds a value outside its range.
+    INVALID_ENUM,
+    // A float is NaN or infinite.
+    NON_FINITE_VALUE,
+    // An index, count or size is out of range.
+    OUT_OF_RANGE,
+    // A fixed-size name is not NUL-terminated.
+    UNTERMINATED_STRING,
+};
+
+static inline const char* BridgeInputEventErrorName(BridgeInputEventError error) {
+    switch (error) {
+        case BridgeInputEventError::NONE:
+            return "NONE";
+        case BridgeInputEventError::UNKNOWN_TYPE:
+            return "UNKNOWN_TYPE";
+        case BridgeInputEventError::INVALID_BOOL:
+            return "INVALID_BOOL";
+        case BridgeInputEventError::INVALID_ENUM:
+            return "INVALID_ENUM";
+        case BridgeInputEventError::NON_FINITE_VALUE:
+            return "NON_FINITE_VALUE";
+        case BridgeInputEventError::OUT_OF_RANGE:
+            return "OUT_OF_RANGE";
+        case BridgeInputEventError::UNTERMINATED_STRING:
+            return "UNTERMINATED_STRING";
+    }
+    return "UNKNOWN";
+}
+
+namespace validator {
+
+static_assert(__BYTE_ORDER__ == __ORDER_LITTLE_ENDIAN__, "range checks mask little-endian loads");
+
+// The slow paths of Rule::flags.
+enum : uint8_t {
+    // Needs ValidateOther() before the masked checks.
+    kCheckOther = 1 << 0,
+    kUnknownType = 1 << 1,
+};
+
+// Checks for one event type, as masked compares that always run: a check the
+// type doesn't need has a zero mask, which can't fail. Offsets are into the
+// args of the event, and each field is loaded as a uint32_t.
+struct Rule {
+    uint8_t flags;
+    uint8_t rangeOffset;
+    uint8_t boolOffset;
+    uint8_t floatOffsets[2];
+    BridgeInputEventError rangeError;
+    // Masks the range checked field down to its width, so signed fields are
+    // checked against their unsigned bounds.
+    uint32_t rangeMask;
+    uint32_t rangeMax;
+    // 0xfe if the byte at boolOffset is a bool.
+    uint32_t boolMask;
+    // kFloatExponent for each float to check.
+    uint32_t floatMasks[2];
+};
+
+// NaN and infinities have all exponent bits set.
+static constexpr uint32_t kFloatExponent = 0x7f800000;
+
+constexpr Rule RangeRule(size_t offset, uint32_t mask, uint32_t max, BridgeInputEventError error) {
+    Rule rule = {};
+    rule.rangeOffset = offset;
+    rule.rangeMask = mask;
+    rule.rangeMax = max;
+    rule.rangeError = error;
+    return rule;
+}
+
+constexpr Rule WithFloats(Rule rule, size_t offset0, size_t offset1 = SIZE_MAX) {
+    rule.floatOffsets[0] = offset0;
+    rule.floatMasks[0] = kFloatExponent;
+    if (offset1 != SIZE_MAX) {
+        rule.floatOffsets[1] = offset1;
+        rule.floatMasks[1] = kFloatExponent;
+    }
+    return rule;
+}
+
+constexpr Rule FloatRule(size_t offset0, size_t offset1 = SIZE_MAX) {
+    return WithFloats(Rule(), offset0, offset1);
+}
+
+constexpr Rule WithBool(Rule rule, size_t offset) {
+    rule.boolOffset = offset;
+    rule.boolMask = 0xfe;
+    return rule;
+}
+
+constexpr Rule WithOther(Rule rule) {
+    rule.flags |= kCheckOther;
+    return rule;
+}
+
+constexpr Rule MakeRule(InputEventType type) {
+    constexpr Rule kNone = {};
+    constexpr BridgeInputEventError kInvalidEnum = BridgeInputEventError::INVALID_ENUM;
+    constexpr BridgeInputEventError kOutOfRange = BridgeInputEventError::OUT_OF_RANGE;
+    switch (type) {
+        case InputEventType::RESET:
+        case InputEventType::KEY_RESET:
+        case InputEventType::KEY_MODIFIERS:
+        case InputEventType::GAMEPAD_CONNECTED_REF:
+        case InputEventType::KEY_CHARACTER_MAP_NAME_REF:
+        case InputEventType::SWITCH:
+        case InputEventType::CLOCK_SYNC:
+            return kNone;
+
+        case InputEventType::POINTER_ENTER:
+        case InputEventType::POINTER_MOVE:
+        case InputEventType::POINTER_LEAVE:
+        case InputEventType::POINTER_SCROLL_X:
+        case InputEventType::POINTER_SCROLL_Y:
+        case InputEventType::POINTER_SCROLL_DISCRETE:
+        case InputEventType::POINTER_SCROLL_STOP:
+        case InputEventType::POINTER_FRAME:
+            return WithBool(FloatRule(offsetof(PointerArgs, x), offsetof(PointerArgs, y)),
+                            offsetof(PointerArgs, discrete));
+        case InputEventType::POINTER_MOVE_RELATIVE:
+            return FloatRule(offsetof(RelativePointerArgs, dx), offsetof(RelativePointerArgs, dy));
+        case InputEventType::POINTER_BUTTON:
+            return RangeRule(offsetof(ButtonArgs, state), UINT32_MAX, 1, kInvalidEnum);
+
+        // TouchArgs overlays x/major/force/tool and y/minor; only the member
+        // the type uses is checked.
+        case InputEventType::TOUCH_DOWN:
+        case InputEventType::TOUCH_MOVE:
+        case InputEventType::TOUCH_UP:
+        case InputEventType::TOUCH_CANCEL:
+        case InputEventType::TOUCH_TILT:
+        case InputEventType::TOUCH_FRAME:
+            return FloatRule(offsetof(TouchArgs, x), offsetof(TouchArgs, y));
+        case InputEventType::TOUCH_SHAPE:
+            return FloatRule(offsetof(TouchArgs, major), offsetof(TouchArgs, minor));
+        case InputEventType::TOUCH_FORCE:
+            return FloatRule(offsetof(TouchArgs, force));
+        case InputEventType::TOUCH_TOOL_TYPE:
+            return RangeRule(offsetof(TouchArgs, tool), UINT8_MAX,
+                             static_cast<uint32_t>(TouchToolType::ERASER), kInvalidEnum);
+
+        case InputEventType::GESTURE_PINCH_BEGIN:
+        case InputEventType::GESTURE_PINCH_END:
+        case InputEventType::GESTURE_SWIPE_BEGIN:
+        case InputEventType::GESTURE_SWIPE_END:
+            return WithBool(kNone, offsetof(GestureArgs, cancelled));
+        case InputEventType::GESTURE_PINCH_UPDATE:
+            return FloatRule(offsetof(GesturePinchArgs, scale));
+        case InputEventType::GESTURE_SWIPE_UPDATE:
+            return FloatRule(offsetof(GestureSwipeArgs, dx), offsetof(GestureSwipeArgs, dy));
+
+        case InputEventType::KEY:
+            return RangeRule(offsetof(KeyArgs, state), UINT32_MAX, 1, kInvalidEnum);
+
+        case InputEventType::GAMEPAD_CONNECTED:
+        case InputEventType::GAMEPAD_AXIS_INFO:
+            return WithOther(kNone);
+        // GamepadArgs overlays button and axis; both are indices.
+        case InputEventType::GAMEPAD_AXIS:
+            return WithBool(WithFloats(RangeRule(offsetof(GamepadArgs, axis), UINT32_MAX,
+                                                 kArcInputBridgeAxisCount - 1, kOutOfRange),
+                                       offsetof(GamepadArgs, value)),
+                            offsetof(GamepadArgs, pressed));
+        case InputEventType::GAMEPAD_BUTTON:
+            return WithBool(WithFloats(RangeRule(offsetof(GamepadArgs, button), UINT32_MAX,
+                                                 INT32_MAX, kOutOfRange),
+                                       offsetof(GamepadArgs, value)),
+                            offsetof(GamepadArgs, pressed));
+        case InputEventType::GAMEPAD_DISCONNECTED:
+        case InputEventType::GAMEPAD_ACTIVATED:
+        case InputEventType::GAMEPAD_FRAME:
+            return WithBool(FloatRule(offsetof(GamepadArgs, value)),
+                            offsetof(GamepadArgs, pressed));
+        case InputEventType::GAMEPAD_SNAPSHOT:
+            return WithOther(WithBool(kNone, offsetof(GamepadSnapshotArgs, endsFrame)));
+
+        case InputEventType::DISPLAY_METRICS:
+            return WithOther(FloatRule(offsetof(DisplayMetricsArgs, ui_scale)));
+        case InputEventType::KEY_CHARACTER_MAP_NAME:
+            return WithOther(kNone);
+        case InputEventType::WIRE_FORMAT:
+            return RangeRule(offsetof(WireFormatArgs, version), UINT8_MAX,
+                             kArcInputBridgeWireVersionCompact, kInvalidEnum);
+        case InputEventType::FRAME_BATCH:
+            return RangeRule(offsetof(FrameBatchArgs, count), UINT32_MAX,
+                             kArcInputBridgeMaxFrameBatchEvents, kOutOfRange);
+        case InputEventType::METADATA:
+        case InputEventType::TOUCH_DELTA_FRAME:
+            // Compact-only, BridgeInputStreamDecoder never hands them out.
+            break;
+    }
+    Rule unknown = {};
+    unknown.flags = kUnknownType;
+    return unknown;
+}
+
+struct Rules {
+    Rule rules[256];
+
+    constexpr Rules() : rules() {
+        for (size_t i = 0; i < 256; i++) {
+            rules[i] = MakeRule(static_cast<InputEventType>(i));
+        }
+    }
+};
+
+// Indexed by the raw type byte, so unknown types need no bounds check.
+inline constexpr Rules kRules;
+
+inline uint32_t LoadArg(const BridgeInputEvent& event, size_t offset) {
+    uint32_t value;
+    memcpy(&value, reinterpret_cast<const uint8_t*>(&event) +
+                   offsetof(BridgeInputEvent, pointer) + offset,
+           sizeof(value));
+    return value;
+}
+
+inline bool IsFinite(float a) {
+    return std::isfinite(a);
+}
+
+inline bool IsTerminated(const char* name, size_t size) {
+    return memchr(name, '\0', size) != nullptr;
+}
+
+// The checks that don't fit in a Rule.
+inline BridgeInputEventError ValidateOther(const BridgeInputEvent& event) {
+    switch (event.type) {
+        case InputEventType::GAMEPAD_CONNECTED:
+            return IsTerminated(event.gamepad_device_info.name,
+                                sizeof(event.gamepad_device_info.name))
+                    ? BridgeInputEventError::NONE
+                    : BridgeInputEventError::UNTERMINATED_STRING;
+        case InputEventType::GAMEPAD_AXIS_INFO:
+            return event.gamepad_axis_info.index < kArcInputBridgeAxisCount &&
+                            event.gamepad_axis_info.minValue <= event.gamepad_axis_info.maxValue
+                    ? BridgeInputEventError::NONE
+                    : BridgeInputEventError::OUT_OF_RANGE;
+        case InputEventType::GAMEPAD_SNAPSHOT: {
+            // The bool is checked first, as the table would.
+            if (LoadArg(event, offsetof(GamepadSnapshotArgs, endsFrame)) & 0xfe) {
+                return BridgeInputEventError::INVALID_BOOL;
+            }
+            uint32_t count = event.gamepad_snapshot.valueCount();
+            if (count > kGamepadSnapshotMaxValues) {
+                return BridgeInputEventError::OUT_OF_RANGE;
+            }
+            for (uint32_t i = 0; i < count; i++) {
+                if (!IsFinite(event.gamepad_snapshot.values[i])) {
+                    return BridgeInputEventError::NON_FINITE_VALUE;
+                }
+            }
+            return BridgeInputEventError::NONE;
+        }
+        case InputEventType::DISPLAY_METRICS:
+            return event.display_metrics.width < 0 || event.display_metrics.height < 0
+                    ? BridgeInputEventError::OUT_OF_RANGE
+                    : BridgeInputEventError::NONE;
+        case InputEventType::KEY_CHARACTER_MAP_NAME:
+            return IsTerminated(event.key_character_map_name.name,
+                                sizeof(event.key_character_map_name.name))
+                    ? BridgeInputEventError::NONE
+                    : BridgeInputEventError::UNTERMINATED_STRING;
+        default:
+            return BridgeInputEventError::NONE;
+    }
+}
+
+}  // namespace validator
+
+// Checks that |event| only holds values its consumers can interpret safely:
+// a known type, and args that are valid for the union member that type uses.
+//
+// The checks are looked up in a table by type and always run as the same few
+// masked compares, so their cost doesn't depend on how predictable the mix of
+// types is; names, axis info, snapshots and display metrics take a slower
+// path. With inputbridge_benchmark on x86-64 (BM_ReadEventsValidated against
+// BM_ReadEvents) this is about 2 ns per event over merely reading the type,
+// against about 1.5 ns for a switch on the type when the sequence of types
+// repeats and 9 ns when it doesn't. That is cheap next to the read() that
+// delivered the event, but not free at a few thousand events per frame.
+static inline BridgeInputEventError ValidateBridgeInputEvent(const BridgeInputEvent& event) {
+    using namespace validator;
+    const Rule& rule = kRules.rules[static_cast<uint8_t>(event.type)];
+    if (rule.flags != 0) {
+        if (rule.flags & kUnknownType) {
+            return BridgeInputEventError::UNKNOWN_TYPE;
+        }
+        BridgeInputEventError error = ValidateOther(event);
+        if (error != BridgeInputEventError::NONE) {
+            return error;
+        }
+    }
+    // Evaluated without branching, since the mix of types defeats prediction.
+    bool badRange = (LoadArg(event, rule.rangeOffset) & rule.rangeMask) > rule.rangeMax;
+    bool badBool = (LoadArg(event, rule.boolOffset) & rule.boolMask) != 0;
+    bool badFloat = ((LoadArg(event, rule.floatOffsets[0]) & rule.floatMasks[0]) ==
+                     kFloatExponent) |
+            ((LoadArg(event, rule.floatOffsets[1]) & rule.floatMasks[1]) == kFloatExponent);
+    if (!(badRange | badBool | badFloat)) {
+        return BridgeInputEventError::NONE;
+    }
+    if (badRange) {
+        return rule.rangeError;
+    }
+    return badBool ? BridgeInputEventError::INVALID_BOOL : BridgeInputEventError::NON_FINITE_VALUE;
+}
+
+// Reference decoder for the legacy wire format: copies one raw
+// BridgeInputEvent out of |data| without any aliasing or alignment
+// assumptions and validates it. |outEvent| must not be used unless this
+// returns BridgeInputEventError::NONE.
+static inline BridgeInputEventError DecodeBridgeInputEvent(const uint8_t* data, size_t size,
+                                                           BridgeInputEvent* outEvent) {
+    if (size < sizeof(BridgeInputEvent)) {
+        return BridgeInputEventError::OUT_OF_RANGE;
+    }
+    memcpy(outEvent, data, sizeof(BridgeInputEvent));
+    return ValidateBridgeInputEvent(*outEvent);
+}
+
+}  // namespace arc
+
+#endif  // _RUNTIME_ARC_INPUT_BRIDGE_VALIDATOR_H
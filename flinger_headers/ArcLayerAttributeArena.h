@@ -0,0 +1,149 @@
+/*
+ * Copyright 2026 The Chromium Authors.
+ *
+ * Permission is hereby granted, free of charge, to any person obtaining a
+ * copy of this software and associated documentation files (the "Software"),
+ * to deal in the Software without restriction, including without limitation
+ * the rights to use, copy, modify, merge, publish, distribute, sublicense,
+ * and/or sell copies of the Software, and to permit persons to whom the
+ * Software is furnished to do so, subject to the following conditions:
+ *
+ * The above copyright notice and this permission notice (including the next
+ * paragraph) shall be included in all copies or substantial portions of the
+ * Software.
+ *
+ * THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+ * IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+ * FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL
+ * THE AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+ * LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING
+ * FROM, OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER
+ * DEALINGS IN THE SOFTWARE.
+ */
+#ifndef _RUNTIME_ARC_LAYER_ATTRIBUTE_ARENA_H
+#define _RUNTIME_ARC_LAYER_ATTRIBUTE_ARENA_H
+
+#include <cstddef>
+#include <cstdint>
+#include <memory>
+#include <vector>
+
+namespace arc {
+
+struct ArcLayerAttributeArenaStats {
+    uint64_t allocations;
+    uint64_t allocatedBytes;
+    // Blocks allocated from the heap. Stays flat once the arena has grown to
+    // the largest frame.
+    uint64_t blocks;
+};
+
+// Device side storage behind arcAllocateAttributeStorage: a per-display bump
+// allocator that lets attribute values written by the framework be kept by
+// reference instead of copied.
+//
+// Lifetime contract: storage allocated during a frame stays valid until
+// Present() is called at the end of the following frame, i.e. the device may
+// reference frame N's values until presentDisplay returns for frame N + 1.
+// Then the storage is reused. A value needed for longer, such as one the
+// framework won't resend because it hasn't changed, must be copied or decoded
+// by then.
+//
+// Two frames are kept, each as a list of blocks. When a frame is recycled its
+// blocks are merged into one, so after warm-up every frame is served from a
+// single block without touching the heap.
+class ArcLayerAttributeArena {
+public:
+    // Allocations are aligned to this.
+    static constexpr size_t kAlignment = 8;
+
+    struct Options {
+        size_t initialCapacity = 16 * 1024;
+    };
+
+    ArcLayerAttributeArena() : ArcLayerAttributeArena(Options()) {}
+    explicit ArcLayerAttributeArena(const Options& options) : mOptions(options) {}
+
+    ArcLayerAttributeArena(const ArcLayerAttributeArena&) = delete;
+    ArcLayerAttributeArena& operator=(const ArcLayerAttributeArena&) = delete;
+
+    // Returns |size| bytes of storage for the current frame.
+    uint8_t* Allocate(size_t size) {
+        Frame& frame = mFrames[mCurrent];
+        size_t offset = (frame.used + kAlignment - 1) & ~(kAlignment - 1);
+        if (frame.blocks.empty() || offset + size > frame.capacity) {
+            size_t capacity = frame.blocks.empty() ? mOptions.initialCapacity : 2 * frame.capacity;
+            AddBlock(&frame, capacity < size ? size : capacity);
+            offset = 0;
+        }
+        frame.used = offset + size;
+        mStats.allocations++;
+        mStats.allocatedBytes += size;
+        return frame.blocks.back().data.get() + offset;
+    }
+
+    // Returns true if [data, data + size) lies in storage handed out for the
+    // current or the previous frame, i.e. may be kept without a copy.
+    bool Contains(const uint8_t* data, size_t size) const {
+        for (const Frame& frame : mFrames) {
+            for (const Block& block : frame.blocks) {
+                const uint8_t* begin = block.data.get();
+                if (data >= begin && data <= begin + block.capacity &&
+                    size <= size_t(begin + block.capacity - data)) {
+                    return true;
+                }
+            }
+        }
+        return false;
+    }
+
+    // Ends the current frame. Storage of the frame before it is reused for
+    // the next one.
+    void Present() {
+        mCurrent ^= 1;
+        Recycle(&mFrames[mCurrent]);
+    }
+
+    const ArcLayerAttributeArenaStats& stats() const { return mStats; }
+
+private:
+    struct Block {
+        std::unique_ptr<uint8_t[]> data;
+        size_t capacity;
+    };
+
+    struct Frame {
+        std::vector<Block> blocks;
+        // Capacity of and bytes used in the last block.
+        size_t capacity = 0;
+        size_t used = 0;
+    };
+
+    void AddBlock(Frame* frame, size_t capacity) {
+        frame->blocks.push_back({std::unique_ptr<uint8_t[]>(new uint8_t[capacity]), capacity});
+        frame->capacity = capacity;
+        frame->used = 0;
+        mStats.blocks++;
+    }
+
+    void Recycle(Frame* frame) {
+        if (frame->blocks.size() > 1) {
+            size_t total = 0;
+            for (const Block& block : frame->blocks) {
+                total += block.capacity;
+            }
+            frame->blocks.clear();
+            AddBlock(frame, total);
+        }
+        frame->used = 0;
+    }
+
+    Options mOptions;
+    Frame mFrames[2];
+    size_t mCurrent = 0;
+    ArcLayerAttributeArenaStats mStats = {};
+};
+
+}  // namespace arc
+
+#endif  // _RUNTIME_ARC_LAYER_ATTRIBUTE_ARENA_H
@@ -0,0 +1,251 @@
+/*
+ * Copyright 2026 The Chromium Authors.
+ *
+ * Permission is hereby granted, free of charge, to any person obtaining a
+ * copy of this software and associated documentation files (the "Software"),
+ * to deal in the Software without restriction, including without limitation
+ * the rights to use, copy, modify, merge, publish, distribute, sublicense,
+ * and/or sell copies of the Software, and to permit persons to whom the
+ * Software is furnished to do so, subject to the following conditions:
+ *
+ * The above copyright notice and this permission notice (including the next
+ * paragraph) shall be included in all copies or substantial portions of the
+ * Software.
+ *
+ * THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+ * IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+ * FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL
+ * THE AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+ * LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING
+ * FROM, OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER
+ * DEALINGS IN THE SOFTWARE.
+ */
+#ifndef _RUNTIME_ARC_LAYER_ATTRIBUTE_CACHE_H
+#define _RUNTIME_ARC_LAYER_ATTRIBUTE_CACHE_H
+
+#include <cstddef>
+#include <cstdint>
+#include <cstring>
+#include <functional>
+#include <unordered_map>
+#include <vector>
+
+namespace arc {
+
+struct ArcLayerAttributeCacheStats {
+    // Attributes whose value matched the cached one and were skipped.
+    uint64_t hits;
+    // Attributes that were new or had changed.
+    uint64_t misses;
+};
+
+// Device side cache of the attributes last applied to each layer through
+// arcSetLayerAttributes, so that the device only decodes the ones that
+// changed.
+//
+// Entries are keyed by (display, layer, attribute id) and hold a copy of the
+// value. Attribute values are a few bytes each, so comparing the bytes costs
+// about as much as hashing them and can't mistake a change for a repeat.
+//
+// Checking and recording are separate steps: FilterChanged() only reports the
+// attributes that differ from the cache, and Commit() records them once the
+// device has validated and applied them. A call that fails part way leaves the
+// cache describing what the layer actually holds, so the retry isn't filtered
+// out.
+//
+// The cache also holds the attribute generation of each layer for
+// arcSetLayerAttributesGeneration and arcGetLayerAttributesGeneration, and
+// the force-update decision for the layer's current attributes, so that
+// arcAttributesShouldForceUpdate, which is passed the attributes that were
+// just set, doesn't decode them a second time: if Matches() finds the
+// arguments equal to all of the applied attributes, answer from
+// ShouldForceUpdate().
+// Matches() is const and leaves the cache and its stats alone, so a query made
+// with other attributes, or before the set, doesn't affect the next set.
+// Remove layers and displays as they are destroyed.
+class ArcLayerAttributeCache {
+public:
+    // Compares the arguments of an arcSetLayerAttributes call against the
+    // cache without recording them. Writes the indices of the attributes that
+    // changed to |outChanged|, which must have room for |numElements|
+    // entries, and returns how many there are.
+    uint32_t FilterChanged(uint64_t display, uint64_t layer, uint32_t numElements,
+                           const int32_t* ids, const uint32_t* sizes,
+                           const uint8_t* const* values, uint32_t* outChanged) {
+        const Layer* entry = Find(display, layer);
+        uint32_t count = 0;
+        for (uint32_t i = 0; i < numElements; i++) {
+            if (entry != nullptr && Matches(*entry, ids[i], values[i], sizes[i])) {
+                mStats.hits++;
+            } else {
+                mStats.misses++;
+                outChanged[count++] = i;
+            }
+        }
+        return count;
+    }
+
+    // Returns true if the arguments of an arcAttributesShouldForceUpdate call
+    // are exactly the applied attributes: every attribute of the layer, each
+    // once, with its applied value. A subset doesn't match, since the
+    // memoized decision was made for all of them. Doesn't update the cache or
+    // the stats.
+    bool Matches(uint64_t display, uint64_t layer, uint32_t numElements, const int32_t* ids,
+                 const uint32_t* sizes, const uint8_t* const* values) const {
+        const Layer* entry = Find(display, layer);
+        if (entry == nullptr || numElements != entry->attributes.size()) {
+            return false;
+        }
+        for (uint32_t i = 0; i < numElements; i++) {
+            if (!Matches(*entry, ids[i], values[i], sizes[i])) {
+                return false;
+            }
+            // Cached ids are unique, so with the counts equal a repeated id
+            // means another attribute is missing.
+            for (uint32_t j = 0; j < i; j++) {
+                if (ids[j] == ids[i]) {
+                    return false;
+                }
+            }
+        }
+        return true;
+    }
+
+    // Records the arguments of an arcSetLayerAttributes call as applied. Call
+    // it only after the device has accepted them.
+    void Commit(uint64_t display, uint64_t layer, uint32_t numElements, const int32_t* ids,
+                const uint32_t* sizes, const uint8_t* const* values) {
+        Layer& entry = mLayers[Key{display, layer}];
+        for (uint32_t i = 0; i < numElements; i++) {
+            Record(&entry, ids[i], values[i], sizes[i]);
+        }
+    }
+
+    // Records |value| as the applied value of attribute |id| of the layer.
+    // Returns true if it differs from the cached one. Like Commit(), call it
+    // only once the value has been applied.
+    bool Update(uint64_t display, uint64_t layer, int32_t id, const uint8_t* value,
+                uint32_t size) {
+        if (!Record(&mLayers[Key{display, layer}], id, value, size)) {
+            mStats.hits++;
+            return false;
+        }
+        mStats.misses++;
+        return true;
+    }
+
+    // Returns the generation last set for the layer, or 0 if there is none.
+    uint64_t GetGeneration(uint64_t display, uint64_t layer) const {
+        const Layer* entry = Find(display, layer);
+        return entry == nullptr ? 0 : entry->generation;
+    }
+
+    void SetGeneration(uint64_t display, uint64_t layer, uint64_t generation) {
+        mLayers[Key{display, layer}].generation = generation;
+    }
+
+    void RemoveLayer(uint64_t display, uint64_t layer) { mLayers.erase(Key{display, layer}); }
+
+    void RemoveDisplay(uint64_t display) {
+        for (auto it = mLayers.begin(); it != mLayers.end();) {
+            if (it->first.display == display) {
+                it = mLayers.erase(it);
+            } else {
+                ++it;
+            }
+        }
+    }
+
+    // Memoizes the force-update decision for the layer's current attributes.
+    // It is forgotten as soon as any attribute of the layer changes.
+    void SetShouldForceUpdate(uint64_t display, uint64_t layer, bool shouldForceUpdate) {
+        Layer& entry = mLayers[Key{display, layer}];
+        entry.forceUpdateKnown = true;
+        entry.shouldForceUpdate = shouldForceUpdate;
+    }
+
+    // Returns false if no decision is memoized for the layer's current
+    // attributes.
+    bool ShouldForceUpdate(uint64_t display, uint64_t layer, bool* outShouldForceUpdate) const {
+        const Layer* entry = Find(display, layer);
+        if (entry == nullptr || !entry->forceUpdateKnown) {
+            return false;
+        }
+        *outShouldForceUpdate = entry->shouldForceUpdate;
+        return true;
+    }
+
+    const ArcLayerAttributeCacheStats& stats() const { return mStats; }
+
+private:
+    struct Key {
+        uint64_t display;
+        uint64_t layer;
+
+        bool operator==(const Key& other) const {
+            return display == other.display && layer == other.layer;
+        }
+    };
+
+    struct KeyHash {
+        size_t operator()(const Key& key) const {
+            return std::hash<uint64_t>()(key.display * 0x9e3779b97f4a7c15 ^ key.layer);
+        }
+    };
+
+    struct Attribute {
+        int32_t id;
+        std::vector<uint8_t> value;
+    };
+
+    // A layer has a handful of attributes, so a linear scan beats a map.
+    struct Layer {
+        uint64_t generation = 0;
+        bool forceUpdateKnown = false;
+        bool shouldForceUpdate = false;
+        std::vector<Attribute> attributes;
+    };
+
+    const Layer* Find(uint64_t display, uint64_t layer) const {
+        auto it = mLayers.find(Key{display, layer});
+        return it == mLayers.end() ? nullptr : &it->second;
+    }
+
+    static bool Matches(const Layer& layer, int32_t id, const uint8_t* value, uint32_t size) {
+        for (const Attribute& attribute : layer.attributes) {
+            if (attribute.id == id) {
+                return attribute.value.size() == size &&
+                        (size == 0 || memcmp(attribute.value.data(), value, size) == 0);
+            }
+        }
+        return false;
+    }
+
+    // Stores |value| and returns true if it differs from the cached one.
+    bool Record(Layer* layer, int32_t id, const uint8_t* value, uint32_t size) {
+        if (Matches(*layer, id, value, size)) {
+            return false;
+        }
+        Attribute* slot = nullptr;
+        for (Attribute& attribute : layer->attributes) {
+            if (attribute.id == id) {
+                slot = &attribute;
+                break;
+            }
+        }
+        if (slot == nullptr) {
+            layer->attributes.push_back({id, {}});
+            slot = &layer->attributes.back();
+        }
+        slot->value.assign(value, value + size);
+        layer->forceUpdateKnown = false;
+        return true;
+    }
+
+    std::unordered_map<Key, Layer, KeyHash> mLayers;
+    ArcLayerAttributeCacheStats mStats = {};
+};
+
+}  // namespace arc
+
+#endif  // _RUNTIME_ARC_LAYER_ATTRIBUTE_CACHE_H
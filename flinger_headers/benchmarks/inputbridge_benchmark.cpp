@@ -0,0 +1,814 @@
+/*
+ * Copyright 2026 The Chromium Authors.
+ *
+ * Permission is hereby granted, free of charge, to any person obtaining a
+ * copy of this software and associated documentation files (the "Software"),
+ * to deal in the Software without restriction, including without limitation
+ * the rights to use, copy, modify, merge, publish, distribute, sublicense,
+ * and/or sell copies of the Software, and to permit persons to whom the
+ * Software is furnished to do so, subject to the following conditions:
+ *
+ * The above copyright notice and this permission notice (including the next
+ * paragraph) shall be included in all copies or substantial portions of the
+ * Software.
+ *
+ * THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+ * IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+ * FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL
+ * THE AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+ * LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING
+ * FROM, OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER
+ * DEALINGS IN THE SOFTWARE.
+ */
+
+// Throughput and latency benchmarks for the BridgeInputEvent wire path.
+//
+// Events are sent as raw BridgeInputEvent structs over a pipe, which is the
+// same kernel object as the kArcInputBridgePipe FIFO. Every benchmark takes
+// the workload, the number of events per write and the CPUs to pin the
+// producer and consumer to (-1 leaves a side unpinned).
+//
+// BM_ReadEvents and BM_ReadEventsValidated show the per-event cost of
+// ValidateBridgeInputEvent on the MIXED workload, in order (0) and shuffled
+// (1).
+//
+// BM_TouchDelta* run on a synthetic 10-finger trace, or on the touch frames of
+// a capture made with inputbridge_capture if INPUTBRIDGE_TOUCH_TRACE names
+// one. BM_MultiProducer* compare several producer threads sharing one pipe
+// with the same threads pushing into a BridgeInputMpscQueue. BM_TouchResample
+// replays the same trace against a 120 Hz vsync.
+//
+// Use --benchmark_format=json (or --benchmark_out=<file>
+// --benchmark_out_format=json) for machine readable output to compare across
+// releases.
+
+#include <fcntl.h>
+#include <pthread.h>
+#include <sched.h>
+#include <signal.h>
+#include <unistd.h>
+
+#include <algorithm>
+#include <atomic>
+#include <cmath>
+#include <cstdlib>
+#include <cstring>
+#include <memory>
+#include <random>
+#include <thread>
+#include <vector>
+
+#include <benchmark/benchmark.h>
+
+#include "ArcInputBridgeCapture.h"
+#include "ArcInputBridgeClock.h"
+#include "ArcInputBridgeDispatcher.h"
+#include "ArcInputBridgeLatency.h"
+#include "ArcInputBridgeMpscQueue.h"
+#include "ArcInputBridgeProtocol.h"
+#include "ArcInputBridgeTouchDelta.h"
+#include "ArcInputBridgeTouchResampler.h"
+#include "ArcInputBridgeValidator.h"
+
+namespace arc {
+namespace {
+
+enum Workload {
+    KEY = 0,
+    TOUCH_MOVE,
+    GAMEPAD_AXIS,
+    GAMEPAD_CONNECTED,
+    MIXED,
+};
+
+void PinToCpu(int64_t cpu) {
+    if (cpu < 0) {
+        return;
+    }
+    cpu_set_t set;
+    CPU_ZERO(&set);
+    CPU_SET(cpu, &set);
+    pthread_setaffinity_np(pthread_self(), sizeof(set), &set);
+}
+
+void Unpin() {
+    cpu_set_t set;
+    CPU_ZERO(&set);
+    for (int i = 0; i < CPU_SETSIZE; i++) {
+        CPU_SET(i, &set);
+    }
+    pthread_setaffinity_np(pthread_self(), sizeof(set), &set);
+}
+
+BridgeInputEvent TouchMove(int32_t id, float x, float y) {
+    BridgeInputEvent event{0, 0, InputEventType::TOUCH_MOVE, {}};
+    event.touch.id = id;
+    event.touch.x = x;
+    event.touch.y = y;
+    return event;
+}
+
+BridgeInputEvent GamepadConnected(int32_t id) {
+    BridgeInputEvent event = BridgeInputEvent::GamepadConnectedEvent(id);
+    strncpy(event.gamepad_device_info.name, "Benchmark Wireless Controller",
+            sizeof(event.gamepad_device_info.name) - 1);
+    return event;
+}
+
+// Returns a repeating trace of events for |workload|.
+std::vector<BridgeInputEvent> MakeTrace(Workload workload) {
+    switch (workload) {
+        case KEY:
+            return {BridgeInputEvent::KeyEvent(0, 30, 1, 1), BridgeInputEvent::KeyEvent(0, 30, 0, 2)};
+        case TOUCH_MOVE:
+            return {TouchMove(0, 100, 200), TouchMove(0, 101, 202)};
+        case GAMEPAD_AXIS:
+            return {BridgeInputEvent::GamepadAxisEvent(0, 0, 0, 0.25f),
+                    BridgeInputEvent::GamepadAxisEvent(0, 0, 1, -0.5f)};
+        case GAMEPAD_CONNECTED:
+            return {GamepadConnected(0)};
+        case MIXED: {
+            // Roughly what a gaming session with touch and a mouse looks like:
+            // two-finger touch frames, mouse motion frames, gamepad axis
+            // frames and the odd key press.
+            std::vector<BridgeInputEvent> trace;
+            for (int i = 0; i < 4; i++) {
+                trace.push_back(TouchMove(0, 100 + i, 200));
+                trace.push_back(TouchMove(1, 300 - i, 200));
+                trace.push_back({0, 0, InputEventType::TOUCH_FRAME, {}});
+                trace.push_back(
+                        BridgeInputEvent::PointerEvent(0, InputEventType::POINTER_MOVE, i, i));
+                trace.push_back(BridgeInputEvent::PointerEvent(0, InputEventType::POINTER_FRAME));
+                trace.push_back(BridgeInputEvent::GamepadAxisEvent(0, 0, 0, i / 4.0f));
+                trace.push_back(BridgeInputEvent::GamepadAxisEvent(0, 0, 1, -i / 4.0f));
+                trace.push_back(BridgeInputEvent::GamepadFrameEvent(0, 0));
+            }
+            trace.push_back(BridgeInputEvent::KeyEvent(0, 30, 1, 1));
+            trace.push_back(BridgeInputEvent::KeyEvent(0, 30, 0, 2));
+            return trace;
+        }
+    }
+    return {};
+}
+
+// Fills |batch| with the next events of |trace| starting at |*cursor|,
+// stamped with the current time.
+void FillBatch(const std::vector<BridgeInputEvent>& trace, size_t* cursor,
+               std::vector<BridgeInputEvent>* batch) {
+    uint64_t now = BridgeInputNowNs();
+    for (BridgeInputEvent& event : *batch) {
+        event = trace[*cursor];
+        event.timestamp = now;
+        *cursor = (*cursor + 1) % trace.size();
+    }
+}
+
+bool ReadEvents(int fd, BridgeInputEvent* events, size_t count) {
+    uint8_t* p = reinterpret_cast<uint8_t*>(events);
+    size_t remaining = count * sizeof(BridgeInputEvent);
+    while (remaining > 0) {
+        ssize_t n = TEMP_FAILURE_RETRY(read(fd, p, remaining));
+        if (n <= 0) {
+            return false;
+        }
+        p += n;
+        remaining -= n;
+    }
+    return true;
+}
+
+void ReportLatency(benchmark::State& state, const BridgeInputLatencyHistogram& latency,
+                   uint64_t events) {
+    state.SetItemsProcessed(events);
+    state.SetBytesProcessed(events * sizeof(BridgeInputEvent));
+    state.counters["latency_p50_ns"] = latency.Percentile(50);
+    state.counters["latency_p99_ns"] = latency.Percentile(99);
+    state.counters["latency_p999_ns"] = latency.Percentile(99.9);
+}
+
+// Saturated throughput: the producer writes batches as fast as the pipe
+// accepts them and the consumer reads them back. Latency here includes time
+// spent queued in a full pipe.
+void BM_PipeThroughput(benchmark::State& state) {
+    Workload workload = static_cast<Workload>(state.range(0));
+    size_t batchSize = state.range(1);
+    int64_t producerCpu = state.range(2);
+    int64_t consumerCpu = state.range(3);
+
+    int fds[2];
+    if (pipe2(fds, O_CLOEXEC) != 0) {
+        state.SkipWithError("pipe2 failed");
+        return;
+    }
+    std::vector<BridgeInputEvent> trace = MakeTrace(workload);
+    std::atomic<bool> stop{false};
+    std::thread producer([&] {
+        PinToCpu(producerCpu);
+        std::vector<BridgeInputEvent> batch(batchSize);
+        size_t cursor = 0;
+        while (!stop.load(std::memory_order_relaxed)) {
+            FillBatch(trace, &cursor, &batch);
+            if (TEMP_FAILURE_RETRY(write(fds[1], batch.data(),
+                                         batchSize * sizeof(BridgeInputEvent))) < 0) {
+                break;
+            }
+        }
+    });
+
+    PinToCpu(consumerCpu);
+    auto latency = std::make_unique<BridgeInputLatencyHistogram>();
+    std::vector<BridgeInputEvent> batch(batchSize);
+    uint64_t events = 0;
+    for (auto _ : state) {
+        if (!ReadEvents(fds[0], batch.data(), batchSize)) {
+            state.SkipWithError("read failed");
+            break;
+        }
+        uint64_t now = BridgeInputNowNs();
+        for (const BridgeInputEvent& event : batch) {
+            latency->Record(now - event.timestamp);
+        }
+        events += batchSize;
+    }
+    Unpin();
+
+    stop = true;
+    // Unblocks the producer with EPIPE.
+    close(fds[0]);
+    producer.join();
+    close(fds[1]);
+    ReportLatency(state, *latency, events);
+}
+
+// Unloaded latency: the producer only sends the next batch once the consumer
+// has acknowledged the previous one, so nothing ever queues in the pipe.
+void BM_PipeLatency(benchmark::State& state) {
+    Workload workload = static_cast<Workload>(state.range(0));
+    size_t batchSize = state.range(1);
+    int64_t producerCpu = state.range(2);
+    int64_t consumerCpu = state.range(3);
+
+    int events[2];
+    int acks[2];
+    if (pipe2(events, O_CLOEXEC) != 0 || pipe2(acks, O_CLOEXEC) != 0) {
+        state.SkipWithError("pipe2 failed");
+        return;
+    }
+    std::vector<BridgeInputEvent> trace = MakeTrace(workload);
+    std::thread producer([&] {
+        PinToCpu(producerCpu);
+        std::vector<BridgeInputEvent> batch(batchSize);
+        size_t cursor = 0;
+        uint8_t ack = 1;
+        while (ack != 0) {
+            FillBatch(trace, &cursor, &batch);
+            if (TEMP_FAILURE_RETRY(write(events[1], batch.data(),
+                                         batchSize * sizeof(BridgeInputEvent))) < 0 ||
+                TEMP_FAILURE_RETRY(read(acks[0], &ack, 1)) != 1) {
+                break;
+            }
+        }
+    });
+
+    PinToCpu(consumerCpu);
+    auto latency = std::make_unique<BridgeInputLatencyHistogram>();
+    std::vector<BridgeInputEvent> batch(batchSize);
+    uint64_t count = 0;
+    for (auto _ : state) {
+        if (!ReadEvents(events[0], batch.data(), batchSize)) {
+            state.SkipWithError("read failed");
+            break;
+        }
+        uint64_t now = BridgeInputNowNs();
+        for (const BridgeInputEvent& event : batch) {
+            latency->Record(now - event.timestamp);
+        }
+        count += batchSize;
+        uint8_t ack = 1;
+        TEMP_FAILURE_RETRY(write(acks[1], &ack, 1));
+    }
+    Unpin();
+
+    // The producer is blocked on a read of the ack pipe; tell it to stop. A
+    // batch it sent meanwhile is left in the pipe and discarded.
+    uint8_t ack = 0;
+    TEMP_FAILURE_RETRY(write(acks[1], &ack, 1));
+    close(events[0]);
+    producer.join();
+    close(events[1]);
+    close(acks[0]);
+    close(acks[1]);
+    ReportLatency(state, *latency, count);
+}
+
+void PipeArgs(benchmark::internal::Benchmark* b) {
+    b->ArgNames({"workload", "batch", "producer_cpu", "consumer_cpu"});
+    int cpus = std::thread::hardware_concurrency();
+    std::vector<std::pair<int64_t, int64_t>> pinnings = {{-1, -1}};
+    if (cpus >= 2) {
+        // Same core (no cross-core wakeups) and different cores.
+        pinnings.push_back({0, 0});
+        pinnings.push_back({0, 1});
+    }
+    for (int64_t workload = KEY; workload <= MIXED; workload++) {
+        for (int64_t batch : {1, 8, 32}) {
+            for (const auto& pinning : pinnings) {
+                b->Args({workload, batch, pinning.first, pinning.second});
+            }
+        }
+    }
+    b->UseRealTime();
+}
+
+BENCHMARK(BM_PipeThroughput)->Apply(PipeArgs);
+BENCHMARK(BM_PipeLatency)->Apply(PipeArgs);
+
+// Several producer threads, range(0) of them, each sending single events as
+// they would from their own input device thread. The consumer reads 64 events
+// per iteration.
+constexpr size_t kMultiProducerEventsPerIteration = 64;
+
+void BM_MultiProducerPipe(benchmark::State& state) {
+    int producers = state.range(0);
+    int fds[2];
+    if (pipe2(fds, O_CLOEXEC) != 0) {
+        state.SkipWithError("pipe2 failed");
+        return;
+    }
+    std::vector<BridgeInputEvent> trace = MakeTrace(MIXED);
+    std::atomic<bool> stop{false};
+    std::vector<std::thread> threads;
+    for (int i = 0; i < producers; i++) {
+        threads.emplace_back([&] {
+            size_t cursor = 0;
+            while (!stop.load(std::memory_order_relaxed)) {
+                BridgeInputEvent event = trace[cursor];
+                cursor = (cursor + 1) % trace.size();
+                event.timestamp = BridgeInputNowNs();
+                if (TEMP_FAILURE_RETRY(write(fds[1], &event, sizeof(event))) < 0) {
+                    break;
+                }
+            }
+        });
+    }
+
+    auto latency = std::make_unique<BridgeInputLatencyHistogram>();
+    std::vector<BridgeInputEvent> batch(kMultiProducerEventsPerIteration);
+    uint64_t events = 0;
+    for (auto _ : state) {
+        if (!ReadEvents(fds[0], batch.data(), batch.size())) {
+            state.SkipWithError("read failed");
+            break;
+        }
+        uint64_t now = BridgeInputNowNs();
+        for (const BridgeInputEvent& event : batch) {
+            latency->Record(now - event.timestamp);
+        }
+        events += batch.size();
+    }
+
+    stop = true;
+    close(fds[0]);
+    for (std::thread& thread : threads) {
+        thread.join();
+    }
+    close(fds[1]);
+    ReportLatency(state, *latency, events);
+}
+BENCHMARK(BM_MultiProducerPipe)->ArgName("producers")->Arg(1)->Arg(2)->Arg(4)->UseRealTime();
+
+void BM_MultiProducerMpscQueue(benchmark::State& state) {
+    int producers = state.range(0);
+    BridgeInputMpscQueue queue;
+    std::vector<std::unique_ptr<BridgeInputMpscQueue::Producer>> handles;
+    for (int i = 0; i < producers; i++) {
+        handles.emplace_back(std::make_unique<BridgeInputMpscQueue::Producer>(&queue, i));
+    }
+    std::vector<BridgeInputEvent> trace = MakeTrace(MIXED);
+    std::atomic<bool> stop{false};
+    std::vector<std::thread> threads;
+    for (int i = 0; i < producers; i++) {
+        threads.emplace_back([&, i] {
+            size_t cursor = 0;
+            while (!stop.load(std::memory_order_relaxed)) {
+                BridgeInputEvent event = trace[cursor];
+                event.timestamp = BridgeInputNowNs();
+                if (handles[i]->Push(event)) {
+                    cursor = (cursor + 1) % trace.size();
+                } else {
+                    sched_yield();
+                }
+            }
+        });
+    }
+
+    auto latency = std::make_unique<BridgeInputLatencyHistogram>();
+    uint64_t events = 0;
+    for (auto _ : state) {
+        for (size_t n = 0; n < kMultiProducerEventsPerIteration;) {
+            BridgeInputEvent event;
+            if (!queue.Pop(&event)) {
+                queue.Wait();
+                continue;
+            }
+            latency->Record(BridgeInputNowNs() - event.timestamp);
+            n++;
+        }
+        events += kMultiProducerEventsPerIteration;
+    }
+
+    stop = true;
+    for (std::thread& thread : threads) {
+        thread.join();
+    }
+    ReportLatency(state, *latency, events);
+    BridgeInputMpscProducerStats total = {};
+    for (const auto& handle : handles) {
+        BridgeInputMpscProducerStats stats = handle->stats();
+        total.pushed += stats.pushed;
+        total.full += stats.full;
+        total.casRetries += stats.casRetries;
+        total.wakeups += stats.wakeups;
+    }
+    if (total.pushed > 0) {
+        state.counters["cas_retries_per_push"] = double(total.casRetries) / total.pushed;
+        state.counters["full_per_push"] = double(total.full) / total.pushed;
+        state.counters["wakeups_per_push"] = double(total.wakeups) / total.pushed;
+    }
+    state.counters["consumer_stalls"] = queue.consumerStats().stalls;
+}
+BENCHMARK(BM_MultiProducerMpscQueue)->ArgName("producers")->Arg(1)->Arg(2)->Arg(4)->UseRealTime();
+
+// Consumer that folds the args of the events it handles into a checksum, so
+// that the dispatch benchmarks below can't be optimized away.
+struct ChecksumHandler {
+    float sum = 0;
+
+    void operator()(InputEventTag<InputEventType::TOUCH_MOVE>, const BridgeInputEvent&,
+                    const TouchArgs& touch) {
+        sum += touch.id + touch.x + touch.y;
+    }
+    void operator()(InputEventTag<InputEventType::POINTER_MOVE>, const BridgeInputEvent&,
+                    const PointerArgs& pointer) {
+        sum += pointer.x + pointer.y;
+    }
+    void operator()(InputEventTag<InputEventType::GAMEPAD_AXIS>, const BridgeInputEvent&,
+                    const GamepadArgs& gamepad) {
+        sum += gamepad.axis + gamepad.value;
+    }
+    void operator()(InputEventTag<InputEventType::KEY>, const BridgeInputEvent&,
+                    const KeyArgs& key) {
+        sum += key.scanCode + key.state;
+    }
+};
+
+// Baseline: the hand-written switch every consumer has today.
+void BM_DispatchSwitch(benchmark::State& state) {
+    std::vector<BridgeInputEvent> trace = MakeTrace(MIXED);
+    float sum = 0;
+    for (auto _ : state) {
+        for (const BridgeInputEvent& event : trace) {
+            switch (event.type) {
+                case InputEventType::TOUCH_MOVE:
+                    sum += event.touch.id + event.touch.x + event.touch.y;
+                    break;
+                case InputEventType::POINTER_MOVE:
+                    sum += event.pointer.x + event.pointer.y;
+                    break;
+                case InputEventType::GAMEPAD_AXIS:
+                    sum += event.gamepad.axis + event.gamepad.value;
+                    break;
+                case InputEventType::KEY:
+                    sum += event.key.scanCode + event.key.state;
+                    break;
+                default:
+                    break;
+            }
+        }
+        benchmark::DoNotOptimize(sum);
+    }
+    state.SetItemsProcessed(state.iterations() * trace.size());
+}
+BENCHMARK(BM_DispatchSwitch);
+
+void BM_DispatchTable(benchmark::State& state) {
+    std::vector<BridgeInputEvent> trace = MakeTrace(MIXED);
+    ChecksumHandler handler;
+    BridgeInputEventDispatcher<ChecksumHandler> dispatcher(handler);
+    for (auto _ : state) {
+        for (const BridgeInputEvent& event : trace) {
+            dispatcher.Dispatch(event);
+        }
+        benchmark::DoNotOptimize(handler.sum);
+    }
+    state.SetItemsProcessed(state.iterations() * trace.size());
+}
+BENCHMARK(BM_DispatchTable);
+
+// Events of the MIXED trace as read() leaves them in the consumer's buffer,
+// plus the odd device event carrying a name. The trace repeats every eight
+// events, which a branch predictor learns. With |shuffled| it is repeated 256
+// times in random order instead, a sequence too long to learn, as with
+// several devices interleaving.
+std::vector<BridgeInputEvent> MakeReadBuffer(bool shuffled) {
+    std::vector<BridgeInputEvent> events = MakeTrace(MIXED);
+    events.push_back(GamepadConnected(1));
+    if (shuffled) {
+        std::vector<BridgeInputEvent> trace = events;
+        for (int i = 1; i < 256; i++) {
+            events.insert(events.end(), trace.begin(), trace.end());
+        }
+        std::shuffle(events.begin(), events.end(), std::mt19937(1));
+    }
+    return events;
+}
+
+void BM_ReadEvents(benchmark::State& state) {
+    std::vector<BridgeInputEvent> events = MakeReadBuffer(state.range(0));
+    for (auto _ : state) {
+        for (const BridgeInputEvent& event : events) {
+            benchmark::DoNotOptimize(event.type);
+        }
+    }
+    state.SetItemsProcessed(state.iterations() * events.size());
+}
+BENCHMARK(BM_ReadEvents)->Arg(0)->Arg(1);
+
+void BM_ReadEventsValidated(benchmark::State& state) {
+    std::vector<BridgeInputEvent> events = MakeReadBuffer(state.range(0));
+    size_t invalid = 0;
+    for (auto _ : state) {
+        for (const BridgeInputEvent& event : events) {
+            benchmark::DoNotOptimize(event.type);
+            invalid += ValidateBridgeInputEvent(event) != BridgeInputEventError::NONE;
+        }
+    }
+    if (invalid > 0) {
+        state.SkipWithError("trace has invalid events");
+    }
+    state.SetItemsProcessed(state.iterations() * events.size());
+}
+BENCHMARK(BM_ReadEventsValidated)->Arg(0)->Arg(1);
+
+using TouchFrames = std::vector<std::vector<BridgeInputEvent>>;
+
+// Ten fingers dragging along slightly noisy curves at 240 Hz for 10 seconds.
+TouchFrames MakeSyntheticTouchTrace() {
+    TouchFrames frames;
+    uint32_t seed = 1;
+    auto noise = [&seed] {
+        seed = seed * 1103515245 + 12345;
+        return ((seed >> 16) % 1000) / 1000.0f - 0.5f;
+    };
+    for (int f = 0; f < 2400; f++) {
+        uint64_t timestamp = f * 4166667ull;
+        std::vector<BridgeInputEvent> frame;
+        for (int id = 0; id < 10; id++) {
+            BridgeInputEvent move = TouchMove(id, 200 + id * 120 + 300 * std::sin(f / 90.0f),
+                                              600 + 250 * std::cos(f / 70.0f + id) + noise());
+            move.timestamp = timestamp;
+            frame.push_back(move);
+        }
+        frame.push_back({timestamp, 0, InputEventType::TOUCH_FRAME, {}});
+        frames.push_back(frame);
+    }
+    return frames;
+}
+
+// Returns the move-only touch frames of the capture at |path|.
+TouchFrames LoadTouchTrace(const char* path) {
+    TouchFrames frames;
+    int fd = open(path, O_RDONLY | O_CLOEXEC);
+    if (fd < 0) {
+        return frames;
+    }
+    auto reader = std::make_unique<BridgeInputCaptureReader>(fd);
+    if (reader->ReadHeader()) {
+        std::vector<BridgeInputEvent> frame;
+        bool movesOnly = true;
+        BridgeInputEvent event;
+        while (reader->Next(&event)) {
+            if (event.type == InputEventType::TOUCH_FRAME) {
+                frame.push_back(event);
+                if (movesOnly && frame.size() > 1) {
+                    frames.push_back(frame);
+                }
+                frame.clear();
+                movesOnly = true;
+            } else if (event.type == InputEventType::TOUCH_MOVE) {
+                frame.push_back(event);
+            } else if (event.type >= InputEventType::TOUCH_DOWN &&
+                       event.type <= InputEventType::TOUCH_TILT) {
+                movesOnly = false;
+            }
+        }
+    }
+    close(fd);
+    return frames;
+}
+
+const TouchFrames& GetTouchTrace() {
+    static const TouchFrames* frames = [] {
+        const char* path = getenv("INPUTBRIDGE_TOUCH_TRACE");
+        TouchFrames loaded = path != nullptr ? LoadTouchTrace(path) : TouchFrames();
+        return new TouchFrames(loaded.empty() ? MakeSyntheticTouchTrace() : loaded);
+    }();
+    return *frames;
+}
+
+// Reports bytes per frame for the legacy, compact and delta encodings.
+void BM_TouchDeltaEncode(benchmark::State& state) {
+    const TouchFrames& frames = GetTouchTrace();
+    std::vector<uint8_t> out;
+    size_t legacyBytes = 0;
+    size_t compactBytes = 0;
+    for (const auto& frame : frames) {
+        legacyBytes += frame.size() * sizeof(BridgeInputEvent);
+        for (const BridgeInputEvent& event : frame) {
+            compactBytes += event.CompactSize();
+        }
+    }
+    for (auto _ : state) {
+        BridgeInputTouchDeltaEncoder encoder;
+        out.clear();
+        for (const auto& frame : frames) {
+            encoder.EncodeFrame(frame.data(), frame.size(), &out);
+        }
+        benchmark::DoNotOptimize(out.data());
+    }
+    state.SetItemsProcessed(state.iterations() * frames.size());
+    state.counters["legacy_bytes_per_frame"] = double(legacyBytes) / frames.size();
+    state.counters["compact_bytes_per_frame"] = double(compactBytes) / frames.size();
+    state.counters["delta_bytes_per_frame"] = double(out.size()) / frames.size();
+    state.counters["delta_vs_legacy_ratio"] = double(legacyBytes) / out.size();
+}
+BENCHMARK(BM_TouchDeltaEncode);
+
+void BM_TouchDeltaDecode(benchmark::State& state) {
+    const TouchFrames& frames = GetTouchTrace();
+    std::vector<uint8_t> encoded;
+    BridgeInputTouchDeltaEncoder encoder;
+    for (const auto& frame : frames) {
+        encoder.EncodeFrame(frame.data(), frame.size(), &encoded);
+    }
+    std::vector<BridgeInputEvent> events;
+    float maxError = 0;
+    for (auto _ : state) {
+        BridgeInputTouchDeltaDecoder decoder;
+        size_t offset = 0;
+        size_t index = 0;
+        while (offset < encoded.size()) {
+            events.clear();
+            size_t consumed =
+                    decoder.DecodeFrame(encoded.data() + offset, encoded.size() - offset, &events);
+            if (consumed == 0) {
+                state.SkipWithError("decode failed");
+                return;
+            }
+            offset += consumed;
+            const auto& frame = frames[index++];
+            for (size_t i = 0; i + 1 < frame.size(); i++) {
+                maxError = std::max(maxError, std::fabs(events[i].touch.x - frame[i].touch.x));
+                maxError = std::max(maxError, std::fabs(events[i].touch.y - frame[i].touch.y));
+            }
+        }
+    }
+    state.SetItemsProcessed(state.iterations() * frames.size());
+    state.counters["max_error_px"] = maxError;
+}
+BENCHMARK(BM_TouchDeltaDecode);
+
+// Position of contact |id| at |time|, linearly interpolated from the trace.
+bool TouchTraceAt(const TouchFrames& frames, uint64_t time, int32_t id, float* x, float* y) {
+    auto next = std::lower_bound(frames.begin(), frames.end(), time,
+                                 [](const std::vector<BridgeInputEvent>& frame, uint64_t t) {
+                                     return frame.back().timestamp < t;
+                                 });
+    if (next == frames.begin() || next == frames.end()) {
+        return false;
+    }
+    const BridgeInputEvent* a = nullptr;
+    const BridgeInputEvent* b = nullptr;
+    for (const BridgeInputEvent& event : *(next - 1)) {
+        if (event.type == InputEventType::TOUCH_MOVE && event.touch.id == id) a = &event;
+    }
+    for (const BridgeInputEvent& event : *next) {
+        if (event.type == InputEventType::TOUCH_MOVE && event.touch.id == id) b = &event;
+    }
+    if (a == nullptr || b == nullptr || b->timestamp <= a->timestamp) {
+        return false;
+    }
+    float alpha = float(time - a->timestamp) / (b->timestamp - a->timestamp);
+    *x = a->touch.x + (b->touch.x - a->touch.x) * alpha;
+    *y = a->touch.y + (b->touch.y - a->touch.y) * alpha;
+    return true;
+}
+
+uint64_t ResampledCount(const BridgeInputTouchResampler::Stats& stats) {
+    return stats.interpolated + stats.extrapolated + stats.passedThrough;
+}
+
+// Feeds the trace through BridgeInputTouchResampler at 120 Hz with a latency
+// of range(0) microseconds. For the resampled positions and for the newest
+// raw samples, reports separately:
+//   *_latency_ms     how far behind the frame time the position is.
+//   *_error_px       its mean distance from the true finger position at its
+//                    own timestamp, i.e. how accurate it is. 0 for raw.
+//   *_frame_error_px its mean distance from the true position at frame time,
+//                    which is what the user sees and includes the latency.
+// Plus how many resampled positions were interpolated.
+void BM_TouchResample(benchmark::State& state) {
+    const TouchFrames& frames = GetTouchTrace();
+    // Vsync runs at its own phase relative to the digitizer.
+    const uint64_t vsyncNs = 8333333;
+    const uint64_t firstFrameTime = frames.front().back().timestamp + 3000000;
+    BridgeInputTouchResampler::Options options;
+    options.latencyNs = state.range(0) * 1000;
+    std::vector<std::vector<BridgeInputEvent>> outputs;
+    std::vector<size_t> latestFrames;
+    // Number of resampled contacts in each output, 0 if it has no resampled
+    // frame.
+    std::vector<uint64_t> resampledCounts;
+    BridgeInputTouchResampler::Stats stats = {};
+    for (auto _ : state) {
+        BridgeInputTouchResampler resampler(options);
+        latestFrames.clear();
+        resampledCounts.clear();
+        size_t vsync = 0;
+        size_t f = 0;
+        for (uint64_t frameTime = firstFrameTime; f < frames.size(); frameTime += vsyncNs) {
+            if (vsync == outputs.size()) {
+                outputs.emplace_back();
+            }
+            outputs[vsync].clear();
+            for (; f < frames.size() && frames[f].back().timestamp <= frameTime; f++) {
+                for (const BridgeInputEvent& event : frames[f]) {
+                    resampler.Add(event, &outputs[vsync]);
+                }
+            }
+            uint64_t resampledBefore = ResampledCount(resampler.stats());
+            resampler.Resample(frameTime, &outputs[vsync++]);
+            resampledCounts.push_back(ResampledCount(resampler.stats()) - resampledBefore);
+            latestFrames.push_back(f > 0 ? f - 1 : 0);
+        }
+        outputs.resize(vsync);
+        stats = resampler.stats();
+        benchmark::DoNotOptimize(outputs.data());
+    }
+    state.SetItemsProcessed(state.iterations() * frames.size());
+
+    double resampledError = 0;
+    double resampledFrameError = 0;
+    double resampledLatency = 0;
+    double rawFrameError = 0;
+    double rawLatency = 0;
+    size_t samples = 0;
+    for (size_t vsync = 0; vsync < outputs.size(); vsync++) {
+        const std::vector<BridgeInputEvent>& out = outputs[vsync];
+        uint64_t frameTime = firstFrameTime + vsync * vsyncNs;
+        // Vsyncs without touches down, or where nothing moved, produce no
+        // resampled frame.
+        if (resampledCounts[vsync] == 0) {
+            continue;
+        }
+        // The resampled frame is the trailing run of moves and its TOUCH_FRAME.
+        for (size_t i = out.size() - 1 - resampledCounts[vsync]; i < out.size() - 1; i++) {
+            const TouchArgs& touch = out[i].touch;
+            float x, y;
+            float sampleX, sampleY;
+            if (!TouchTraceAt(frames, frameTime, touch.id, &x, &y) ||
+                !TouchTraceAt(frames, out[i].timestamp, touch.id, &sampleX, &sampleY)) {
+                continue;
+            }
+            for (const BridgeInputEvent& event : frames[latestFrames[vsync]]) {
+                if (event.type == InputEventType::TOUCH_MOVE && event.touch.id == touch.id) {
+                    rawFrameError += std::hypot(event.touch.x - x, event.touch.y - y);
+                    rawLatency += frameTime - event.timestamp;
+                }
+            }
+            resampledError += std::hypot(touch.x - sampleX, touch.y - sampleY);
+            resampledFrameError += std::hypot(touch.x - x, touch.y - y);
+            resampledLatency += frameTime - out[i].timestamp;
+            samples++;
+        }
+    }
+    uint64_t resampled = ResampledCount(stats);
+    state.counters["resampled_error_px"] = samples ? resampledError / samples : 0;
+    state.counters["resampled_frame_error_px"] = samples ? resampledFrameError / samples : 0;
+    state.counters["resampled_latency_ms"] = samples ? resampledLatency / samples / 1e6 : 0;
+    state.counters["raw_frame_error_px"] = samples ? rawFrameError / samples : 0;
+    state.counters["raw_latency_ms"] = samples ? rawLatency / samples / 1e6 : 0;
+    state.counters["interpolated_ratio"] = resampled ? double(stats.interpolated) / resampled : 0;
+}
+BENCHMARK(BM_TouchResample)->ArgName("latency_us")->Arg(0)->Arg(1000)->Arg(2000)->Arg(5000);
+
+}  // namespace
+}  // namespace arc
+
+int main(int argc, char** argv) {
+    // Writes to a pipe whose read end is closed must fail rather than kill us.
+    signal(SIGPIPE, SIG_IGN);
+    benchmark::Initialize(&argc, argv);
+    benchmark::RunSpecifiedBenchmarks();
+    return 0;
+}
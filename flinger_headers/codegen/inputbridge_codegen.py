@@ -0,0 +1,670 @@
+#!/usr/bin/env python3
+#
+# Copyright 2026 The Chromium Authors.
+#
+# Permission is hereby granted, free of charge, to any person obtaining a
+# copy of this software and associated documentation files (the "Software"),
+# to deal in the Software without restriction, including without limitation
+# the rights to use, copy, modify, merge, publish, distribute, sublicense,
+# and/or sell copies of the Software, and to permit persons to whom the
+# Software is furnished to do so, subject to the following conditions:
+#
+# The above copyright notice and this permission notice (including the next
+# paragraph) shall be included in all copies or substantial portions of the
+# Software.
+#
+# THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+# IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+# FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL
+# THE AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+# LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING
+# FROM, OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER
+# DEALINGS IN THE SOFTWARE.
+
+"""Generates ArcInputBridgeProtocol.h from schema/ArcInputBridgeProtocol.xml.
+
+Usage:
+  inputbridge_codegen.py SCHEMA > ArcInputBridgeProtocol.h
+  inputbridge_codegen.py --check HEADER SCHEMA
+
+--check exits with an error if HEADER is not what SCHEMA generates.
+"""
+
+import argparse
+import sys
+import textwrap
+import xml.etree.ElementTree as ET
+
+COLUMNS = 100
+EVENT = 'BridgeInputEvent'
+HEADER = 'BridgeInputEventCompactHeader'
+
+# Sizes of the scalar types the schema may use. Enums add their own.
+SCALAR_SIZES = {
+    'bool': 1,
+    'char': 1,
+    'int8_t': 1,
+    'uint8_t': 1,
+    'int16_t': 2,
+    'uint16_t': 2,
+    'int32_t': 4,
+    'uint32_t': 4,
+    'float': 4,
+    'int64_t': 8,
+    'uint64_t': 8,
+}
+
+
+class SchemaError(Exception):
+    pass
+
+
+def doc_lines(element):
+    doc = element.find('doc')
+    if doc is None or doc.text is None:
+        return []
+    return textwrap.dedent(doc.text).strip('\n').splitlines()
+
+
+def comment(lines, indent):
+    return [indent + ('// ' + line if line else '//') for line in lines]
+
+
+def code_lines(text, indent):
+    return [indent + line if line else '' for line in
+            textwrap.dedent(text).strip('\n').splitlines()]
+
+
+def blank_line_before(previous):
+    """Whether the schema has a blank line between |previous| and the next element."""
+    return previous is not None and (previous.tail or '').count('\n') > 1
+
+
+def wrap(prefix, terms, separator, suffix, continuation):
+    """Joins |terms| after |prefix|, breaking lines at COLUMNS.
+
+    |separator| follows every term but the last, and continuation lines are
+    indented with |continuation|.
+    """
+    lines = []
+    line = prefix
+    for i, term in enumerate(terms):
+        piece = term + (separator if i + 1 < len(terms) else suffix)
+        candidate = line + piece
+        if len(candidate.rstrip()) > COLUMNS and line.strip() and line != prefix:
+            lines.append(line.rstrip())
+            line = continuation + piece
+        else:
+            line = candidate
+    lines.append(line.rstrip())
+    return lines
+
+
+class Field:
+    def __init__(self, element, schema):
+        self.name = element.get('name')
+        self.type = element.get('type')
+        self.length = element.get('length')
+        self.count = element.get('count')
+        self.doc = doc_lines(element)
+        self.element_size = schema.type_size(self.type)
+        self.size = self.element_size * (schema.value_of(self.length) if self.length else 1)
+
+
+class Struct:
+    def __init__(self, element, schema):
+        self.name = element.get('name')
+        self.member = element.get('member')
+        self.packed = element.get('packed', 'true') == 'true'
+        self.compact_only = element.get('compact-only') == 'true'
+        self.element = element
+        # (offset, Field) for every field, including union members.
+        self.fields = []
+        self.variable = None
+        offset = 0
+        for child in element:
+            if child.tag == 'field':
+                field = Field(child, schema)
+                self.fields.append((offset, field))
+                offset += field.size
+            elif child.tag == 'union':
+                members = [Field(f, schema) for f in child.findall('field')]
+                for field in members:
+                    self.fields.append((offset, field))
+                offset += max(field.size for field in members)
+        self.size = offset
+        for position, (offset, field) in enumerate(self.fields):
+            if field.count is None:
+                continue
+            if position + 1 != len(self.fields) or not field.length:
+                raise SchemaError('%s.%s: only a trailing array can have a count' %
+                                  (self.name, field.name))
+            self.variable = (offset, field)
+
+
+class Schema:
+    def __init__(self, root):
+        self.root = root
+        self.constants = {}
+        self.sizes = dict(SCALAR_SIZES)
+        self.structs = []
+        self.events = []
+        self.args_size = int(root.get('event-args-size'))
+        for element in root:
+            if element.tag == 'constant':
+                self.constants[element.get('name')] = element.get('value')
+            elif element.tag == 'enum':
+                self.sizes[element.get('name')] = SCALAR_SIZES[element.get('type')]
+            elif element.tag == 'struct':
+                self.structs.append(Struct(element, self))
+            elif element.tag == 'events':
+                self.sizes['InputEventType'] = SCALAR_SIZES[element.get('type')]
+                self.events = element.findall('event')
+        self.by_member = {struct.member: struct for struct in self.structs}
+        # The structs BridgeInputEvent's union holds. Compact-only ones are
+        # only ever sent as compact records.
+        self.union_structs = [struct for struct in self.structs if not struct.compact_only]
+        for event in self.events:
+            args = event.get('args')
+            if args != 'none' and args not in self.by_member:
+                raise SchemaError('%s uses unknown args %s' % (event.get('name'), args))
+        union = max(struct.size for struct in self.union_structs)
+        if union != self.args_size:
+            raise SchemaError('the args union is %d bytes but event-args-size is %d; '
+                              'BridgeInputEvent is the pipe ABI and must not change size' %
+                              (union, self.args_size))
+
+    def type_size(self, name):
+        if name in self.sizes:
+            return self.sizes[name]
+        raise SchemaError('unknown type %s' % name)
+
+    def value_of(self, expression):
+        return int(self.constants.get(expression, expression))
+
+    def struct_of(self, event):
+        return self.by_member.get(event.get('args'))
+
+    def events_using(self, struct):
+        return [e.get('name') for e in self.events if e.get('args') == struct.member]
+
+    def is_compact_only(self, event):
+        struct = self.struct_of(event)
+        return struct is not None and struct.compact_only
+
+
+def emit_constant(element):
+    lines = comment(doc_lines(element), '')
+    name, type, value = element.get('name'), element.get('type'), element.get('value')
+    if type == 'const char*':
+        lines.append('static const char* %s = %s;' % (name, value))
+    else:
+        lines.append('static constexpr %s %s = %s;' % (type, name, value))
+    return lines
+
+
+def emit_enum(element):
+    entries = element.findall('entry')
+    values = ['%s = %s' % (e.get('name'), e.get('value')) if e.get('value') else e.get('name')
+              for e in entries]
+    lines = comment(doc_lines(element), '')
+    lines.append('enum class %s : %s { %s };' % (element.get('name'), element.get('type'),
+                                                ', '.join(values)))
+    return lines
+
+
+def emit_events(schema, element):
+    lines = ['enum class InputEventType : %s {' % element.get('type')]
+    previous = None
+    for i, event in enumerate(schema.events):
+        if blank_line_before(previous):
+            lines.append('')
+        lines += comment(doc_lines(event), '    ')
+        lines.append('    %s%s,' % (event.get('name'), ' = 0' if i == 0 else ''))
+        previous = event
+    last = schema.events[-1].get('name')
+    lines += [
+        '};',
+        '',
+        '// Number of InputEventType values.',
+        'static constexpr size_t kInputEventTypeCount =',
+        '        static_cast<size_t>(InputEventType::%s) + 1;' % last,
+        '',
+        'static inline const char* InputEventTypeName(InputEventType type) {',
+        '    switch (type) {',
+    ]
+    for event in schema.events:
+        lines.append('        case InputEventType::%s:' % event.get('name'))
+        lines.append('            return "%s";' % event.get('name'))
+    lines += [
+        '    }',
+        '    return "UNKNOWN";',
+        '}',
+        '',
+        '// Returns true for the events that terminate a frame.',
+        'static inline bool IsFrameTerminator(InputEventType type) {',
+    ]
+    terminators = ['type == InputEventType::%s' % e.get('name') for e in schema.events
+                   if e.get('frame-terminator') == 'true']
+    lines += wrap('    return ', terminators, ' || ', ';', ' ' * 12)
+    lines += [
+        '}',
+        '',
+        '// Returns true for the events whose args BridgeInputEvent can\'t hold. They',
+        '// only exist as compact records, written with',
+        '// BridgeInputEvent::EncodeCompactRecord(), and BridgeInputStreamDecoder',
+        '// consumes them rather than hands them out.',
+        'static inline bool IsCompactOnly(InputEventType type) {',
+    ]
+    compact_only = ['type == InputEventType::%s' % e.get('name') for e in schema.events
+                    if schema.is_compact_only(e)]
+    lines += wrap('    return ', compact_only or ['false'], ' || ', ';', ' ' * 12)
+    lines += [
+        '}',
+        '',
+        '// Args of the event types that don\'t carry any.',
+        'struct NoArgs {};',
+    ]
+    return lines
+
+
+def emit_field(field, indent):
+    lines = comment(field.doc, indent)
+    suffix = '[%s]' % field.length if field.length else ''
+    lines.append('%s%s %s%s;' % (indent, field.type, field.name, suffix))
+    return lines
+
+
+def emit_struct(schema, struct):
+    lines = comment(doc_lines(struct.element), '')
+    lines.append('struct %s {' % struct.name)
+    for child in struct.element:
+        if child.tag == 'field':
+            lines += emit_field(Field(child, schema), '    ')
+        elif child.tag == 'union':
+            lines.append('    union {')
+            for field in child.findall('field'):
+                lines += emit_field(Field(field, schema), '        ')
+            lines.append('    };')
+        elif child.tag == 'code':
+            lines.append('')
+            lines += code_lines(child.text, '    ')
+    lines.append('} __attribute__((packed));' if struct.packed else '};')
+    return lines
+
+
+def emit_factory(element):
+    name = element.get('name')
+    args = element.findall('arg')
+    params = []
+    if not any(arg.get('name') == 'timestamp' for arg in args):
+        params.append('uint64_t timestamp')
+    for arg in args:
+        default = arg.get('default')
+        params.append('%s %s%s' % (arg.get('type'), arg.get('name'),
+                                   ' = ' + default if default is not None else ''))
+    event_type = element.get('event')
+    type_expression = 'InputEventType::' + event_type if event_type else 'type'
+
+    prefix = '    static %s %s(' % (EVENT, name)
+    lines = comment(doc_lines(element), '    ')
+    lines += wrap(prefix, params, ', ', ') {', ' ' * len(prefix))
+    body = element.find('body')
+    assignments = [arg for arg in args if arg.get('field') not in (None, 'type')]
+    if body is None and not assignments:
+        lines.append('        return {timestamp, -1, %s, {}};' % type_expression)
+    else:
+        lines.append('        %s event{timestamp, -1, %s, {}};' % (EVENT, type_expression))
+        if body is not None:
+            lines += code_lines(body.text, '        ')
+        for arg in assignments:
+            lines.append('        event.%s = %s;' % (arg.get('field'), arg.get('name')))
+        lines.append('        return event;')
+    lines.append('    }')
+    return lines
+
+
+def emit_compact_size(schema):
+    lines = [
+        '    // Returns the number of bytes EncodeCompact writes for this event.',
+    ]
+    variable = [s for s in schema.union_structs if s.variable and schema.events_using(s)]
+    if variable:
+        names = [s.variable[1].name for s in variable]
+        lines.append('    // Only the used part of %s is sent.' % ', '.join(
+                '%s::%s' % (s.name, n) for s, n in zip(variable, names)))
+    lines.append('    size_t CompactSize() const {')
+    for struct in variable:
+        offset, field = struct.variable
+        terms = ['type == InputEventType::%s' % e for e in schema.events_using(struct)]
+        lines += wrap('        if (', terms, ' || ', ') {', ' ' * 12)
+        count = '%s.%s' % (struct.member, field.count)
+        # Clamp to the array the field is declared with rather than repeating a
+        # literal length, so the two can't drift apart.
+        limit = field.length
+        if limit.isdigit():
+            array = '%s.%s' % (struct.member, field.name)
+            limit = 'sizeof(%s)' % array
+            if field.element_size != 1:
+                limit += ' / sizeof(%s[0])' % array
+        lines += [
+            '            size_t count = %s;' % count,
+            '            if (count > %s) {' % limit,
+            '                count = %s;' % limit,
+            '            }',
+            '            return sizeof(%s) + offsetof(%s, %s) +' % (HEADER, struct.name,
+                                                                   field.name),
+            '                    count%s;' % (
+                    '' if field.element_size == 1 else ' * sizeof(%s)' % field.type),
+            '        }',
+        ]
+    lines += [
+        '        return sizeof(%s) + ArgsSize(type);' % HEADER,
+        '    }',
+    ]
+    return lines
+
+
+def emit_bridge_input_event(schema):
+    lines = [
+        '// Header of a record in the compact wire format. |length| covers the header',
+        '// and the args that follow it, so consumers can skip records of types they',
+        '// don\'t know about.',
+        'struct %s {' % HEADER,
+        '    uint16_t length;',
+        '    uint64_t timestamp;',
+        '    int32_t displayId;',
+        '    InputEventType type;',
+        '} __attribute__((packed));',
+        '',
+        '// Union-like class describing an event. The InputEventType describes which',
+        '// of member of the union contains the data of this event.',
+        'struct %s {' % EVENT,
+        '    uint64_t timestamp;',
+        '    int32_t displayId;',
+        '',
+        '    InputEventType type;',
+        '',
+        '    union {',
+    ]
+    for struct in schema.union_structs:
+        lines.append('        %s %s;' % (struct.name, struct.member))
+    lines.append('    };')
+    for factory in schema.root.findall('factory'):
+        lines.append('')
+        lines += emit_factory(factory)
+    lines += [
+        '',
+        '    // Returns the size of the args struct used by |type|. Unknown types use',
+        '    // the whole union.',
+        '    static size_t ArgsSize(InputEventType type);',
+        '',
+    ]
+    lines += emit_compact_size(schema)
+    lines += [
+        '',
+        '    // Writes this event in the compact wire format to |out|. Returns the number',
+        '    // of bytes written, or 0 if |size| is too small.',
+        '    size_t EncodeCompact(uint8_t* out, size_t size) const;',
+        '',
+        '    // Reads one compact record from |in| into |outEvent|. Returns the number of',
+        '    // bytes consumed, or 0 if |in| doesn\'t hold a complete, well-formed record.',
+        '    // Once |size| reaches kMaxCompactSize a return value of 0 means the stream',
+        '    // is corrupt.',
+        '    // Records of compact-only types are consumed with their args left zeroed,',
+        '    // since the event can\'t hold them; their args are the record\'s last',
+        '    // length - sizeof(%s) bytes.' % HEADER,
+        '    static size_t DecodeCompact(const uint8_t* in, size_t size, '
+        '%s* outEvent);' % EVENT,
+        '',
+        '    // Writes a record of the compact-only |type| with |args| as its args to',
+        '    // |out|. Returns the number of bytes written, or 0 if |size| is too small or',
+        '    // the record would be longer than kMaxCompactSize.',
+        '    static size_t EncodeCompactRecord(uint64_t timestamp, int32_t displayId,',
+        '                                      InputEventType type, const void* args,',
+        '                                      size_t argsSize, uint8_t* out, size_t size);',
+        '',
+        '    static const size_t kMaxCompactSize;',
+        '} __attribute__((packed));',
+    ]
+    return lines
+
+
+def emit_layout_asserts(schema):
+    args_offset = 8 + 4 + schema.type_size('InputEventType')
+    header_size = 2 + args_offset
+    lines = [
+        '// The layouts below are the pipe ABI. They are computed from the schema by the',
+        '// generator, so these only fail if the compiler lays a struct out differently.',
+    ]
+    asserts = [
+        ('sizeof(%s)' % EVENT, args_offset + schema.args_size),
+        ('offsetof(%s, %s)' % (EVENT, schema.union_structs[0].member), args_offset),
+        ('sizeof(%s)' % HEADER, header_size),
+    ]
+    for struct in schema.structs:
+        asserts.append(('sizeof(%s)' % struct.name, struct.size))
+        for offset, field in struct.fields:
+            if offset:
+                asserts.append(('offsetof(%s, %s)' % (struct.name, field.name), offset))
+    for expression, value in asserts:
+        lines += wrap('static_assert(', ['%s == %d,' % (expression, value),
+                                         '"wire format changed");'], ' ', '', ' ' * 14)
+    return lines
+
+
+def emit_args_size(schema):
+    lines = [
+        'inline size_t %s::ArgsSize(InputEventType type) {' % EVENT,
+        '    switch (type) {',
+    ]
+    groups = []
+    for event in schema.events:
+        args = event.get('args')
+        for group in groups:
+            if group[0] == args:
+                group[1].append(event.get('name'))
+                break
+        else:
+            groups.append((args, [event.get('name')]))
+    groups.sort(key=lambda group: group[0] != 'none')
+    for args, names in groups:
+        for name in names:
+            lines.append('        case InputEventType::%s:' % name)
+        if args == 'none':
+            lines.append('            return 0;')
+        else:
+            lines.append('            return sizeof(%s);' % schema.by_member[args].name)
+    lines += [
+        '    }',
+        '    return sizeof(%s) - offsetof(%s, %s);' % (EVENT, EVENT,
+                                                   schema.union_structs[0].member),
+        '}',
+    ]
+    return lines
+
+
+def emit_encode_decode(schema):
+    first = schema.union_structs[0].member
+    lines = [
+        'inline size_t %s::EncodeCompact(uint8_t* out, size_t size) const {' % EVENT,
+        '    size_t length = CompactSize();',
+        '    if (size < length) {',
+        '        return 0;',
+        '    }',
+        '    %s header{static_cast<uint16_t>(length), timestamp, displayId,' % HEADER,
+        '                                         type};',
+        '    memcpy(out, &header, sizeof(header));',
+        '    memcpy(out + sizeof(header), reinterpret_cast<const uint8_t*>(this) +',
+        '                   offsetof(%s, %s),' % (EVENT, first),
+        '           length - sizeof(header));',
+        '    return length;',
+        '}',
+        '',
+        'inline size_t %s::DecodeCompact(const uint8_t* in, size_t size,' % EVENT,
+        '                                              %s* outEvent) {' % EVENT,
+        '    %s header;' % HEADER,
+        '    if (size < sizeof(header)) {',
+        '        return 0;',
+        '    }',
+        '    memcpy(&header, in, sizeof(header));',
+        '    if (header.length < sizeof(header) || header.length > kMaxCompactSize ||',
+        '        header.length > size) {',
+        '        return 0;',
+        '    }',
+        '    *outEvent = {header.timestamp, header.displayId, header.type, {}};',
+        '    if (IsCompactOnly(header.type)) {',
+        '        return header.length;',
+        '    }',
+        '    size_t argsSize = header.length - sizeof(header);',
+        '    memcpy(reinterpret_cast<uint8_t*>(outEvent) + offsetof(%s, %s),' % (EVENT, first),
+        '           in + sizeof(header), argsSize);',
+    ]
+    for struct in schema.union_structs:
+        if not struct.variable or struct.variable[1].count.endswith(')'):
+            continue
+        offset, field = struct.variable
+        data = 'offsetof(%s, %s)' % (struct.name, field.name)
+        sent = 'argsSize - ' + data
+        if field.element_size != 1:
+            sent = '(%s) / sizeof(%s)' % (sent, field.type)
+        terms = ['header.type == InputEventType::%s' % e for e in schema.events_using(struct)]
+        lines += wrap('    if (', terms, ' || ', ') {', ' ' * 8)
+        lines += [
+            '        // Never trust the count to cover more than what was actually sent.',
+            '        size_t sent = argsSize > %s' % data,
+            '                ? %s' % sent,
+            '                : 0;',
+            '        if (outEvent->%s.%s > sent) {' % (struct.member, field.count),
+            '            outEvent->%s.%s = sent;' % (struct.member, field.count),
+            '        }',
+            '    }',
+        ]
+    lines += [
+        '    return header.length;',
+        '}',
+        '',
+        'inline size_t %s::EncodeCompactRecord(uint64_t timestamp, int32_t displayId,' % EVENT,
+        '                                                   InputEventType type, const void* args,',
+        '                                                   size_t argsSize, uint8_t* out,',
+        '                                                   size_t size) {',
+        '    size_t length = sizeof(%s) + argsSize;' % HEADER,
+        '    if (size < length || length > kMaxCompactSize) {',
+        '        return 0;',
+        '    }',
+        '    %s header{static_cast<uint16_t>(length), timestamp, displayId,' % HEADER,
+        '                                         type};',
+        '    memcpy(out, &header, sizeof(header));',
+        '    memcpy(out + sizeof(header), args, argsSize);',
+        '    return length;',
+        '}',
+    ]
+    return lines
+
+
+def emit_x_macro(schema):
+    entries = []
+    for event in schema.events:
+        struct = schema.struct_of(event)
+        if schema.is_compact_only(event):
+            continue
+        if struct is None:
+            entries.append('X(%s, NoArgs, none)' % event.get('name'))
+        else:
+            entries.append('X(%s, %s, %s)' % (event.get('name'), struct.name, struct.member))
+    head = '#define ARC_INPUT_BRIDGE_EVENT_TYPES(X)'
+    width = max(len(head), max(len(e) + 4 for e in entries)) + 1
+    lines = [
+        '// Calls X(eventType, argsType, member) for every InputEventType but the',
+        '// compact-only ones, where |member| is the field of BridgeInputEvent\'s union',
+        '// holding the args. Types without args use NoArgs and |member| none.',
+        head.ljust(width) + '\\',
+    ]
+    for i, entry in enumerate(entries):
+        line = '    ' + entry
+        lines.append(line if i + 1 == len(entries) else line.ljust(width) + '\\')
+    return lines
+
+
+def generate(root):
+    schema = Schema(root)
+    copyright = textwrap.dedent(root.find('copyright').text).strip('\n').splitlines()
+    out = ['/*']
+    out += [' * ' + line if line else ' *' for line in copyright]
+    out += [
+        ' */',
+        '',
+        '// Generated by codegen/inputbridge_codegen.py from',
+        '// schema/ArcInputBridgeProtocol.xml. Do not edit.',
+        '',
+        '#ifndef _RUNTIME_ARC_INPUT_BRIDGE_PROTOCOL_H',
+        '#define _RUNTIME_ARC_INPUT_BRIDGE_PROTOCOL_H',
+        '',
+        '#include <cstddef>',
+        '#include <cstdint>',
+        '#include <cstring>',
+        '',
+        '// Hack: major/minor may be defined by stdlib in error.',
+        '// see https://sourceware.org/bugzilla/show_bug.cgi?id=19239',
+        '#undef major',
+        '#undef minor',
+        '',
+        'namespace arc {',
+    ]
+    previous = None
+    for element in root:
+        if element.tag == 'copyright':
+            continue
+        if element.tag == 'factory':
+            break
+        lines = []
+        if element.tag == 'constant':
+            lines = emit_constant(element)
+        elif element.tag == 'enum':
+            lines = emit_enum(element)
+        elif element.tag == 'events':
+            lines = emit_events(schema, element)
+        elif element.tag == 'struct':
+            lines = emit_struct(schema, [s for s in schema.structs if s.element is element][0])
+        if previous is None or previous.tag == 'copyright' or blank_line_before(previous):
+            out.append('')
+        out += lines
+        previous = element
+    for section in (emit_bridge_input_event(schema), emit_layout_asserts(schema), [
+            'inline const size_t %s::kMaxCompactSize =' % EVENT,
+            '        sizeof(%s) + sizeof(%s) -' % (HEADER, EVENT),
+            '        offsetof(%s, %s);' % (EVENT, schema.union_structs[0].member),
+    ], emit_args_size(schema), emit_encode_decode(schema), emit_x_macro(schema)):
+        out.append('')
+        out += section
+    out += [
+        '',
+        '}  // namespace arc',
+        '',
+        '#endif  // _RUNTIME_ARC_INPUT_BRIDGE_PROTOCOL_H',
+    ]
+    return '\n'.join(out) + '\n'
+
+
+def main():
+    parser = argparse.ArgumentParser(description=__doc__,
+                                     formatter_class=argparse.RawDescriptionHelpFormatter)
+    parser.add_argument('--check', metavar='HEADER',
+                        help='verify HEADER instead of printing the generated header')
+    parser.add_argument('schema')
+    args = parser.parse_args()
+    try:
+        header = generate(ET.parse(args.schema).getroot())
+    except SchemaError as e:
+        sys.exit('%s: %s' % (args.schema, e))
+    if args.check is None:
+        sys.stdout.write(header)
+        return
+    with open(args.check) as f:
+        if f.read() != header:
+            sys.exit('%s is out of date, regenerate it with:\n  %s %s > %s' %
+                     (args.check, sys.argv[0], args.schema, args.check))
+
+
+if __name__ == '__main__':
+    main()
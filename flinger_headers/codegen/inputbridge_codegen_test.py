@@ -0,0 +1,64 @@
+#!/usr/bin/env python3
+#
+# Copyright 2026 The Chromium Authors.
+#
+# Permission is hereby granted, free of charge, to any person obtaining a
+# copy of this software and associated documentation files (the "Software"),
+# to deal in the Software without restriction, including without limitation
+# the rights to use, copy, modify, merge, publish, distribute, sublicense,
+# and/or sell copies of the Software, and to permit persons to whom the
+# Software is furnished to do so, subject to the following conditions:
+#
+# The above copyright notice and this permission notice (including the next
+# paragraph) shall be included in all copies or substantial portions of the
+# Software.
+#
+# THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+# IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+# FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL
+# THE AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+# LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING
+# FROM, OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER
+# DEALINGS IN THE SOFTWARE.
+
+"""Checks that the checked-in ArcInputBridgeProtocol.h matches its schema.
+
+Run it from flinger_headers with:
+  python3 -m unittest codegen.inputbridge_codegen_test
+"""
+
+import os
+import sys
+import unittest
+import xml.etree.ElementTree as ET
+
+from codegen import inputbridge_codegen
+
+SCHEMA = os.path.join('schema', 'ArcInputBridgeProtocol.xml')
+HEADER = 'ArcInputBridgeProtocol.h'
+
+
+def data_dir():
+    # Installed tests keep their data next to the test binary; in the source
+    # tree it is the parent of codegen/.
+    for candidate in (os.path.dirname(os.path.abspath(sys.argv[0])),
+                      os.path.dirname(os.path.dirname(os.path.abspath(__file__)))):
+        if os.path.exists(os.path.join(candidate, SCHEMA)):
+            return candidate
+    raise FileNotFoundError(SCHEMA)
+
+
+class ProtocolHeaderTest(unittest.TestCase):
+
+    def test_header_matches_schema(self):
+        root = data_dir()
+        generated = inputbridge_codegen.generate(ET.parse(os.path.join(root, SCHEMA)).getroot())
+        with open(os.path.join(root, HEADER)) as f:
+            checked_in = f.read()
+        self.assertTrue(checked_in == generated,
+                        '%s is out of date, regenerate it with:\n'
+                        '  codegen/inputbridge_codegen.py %s > %s' % (HEADER, SCHEMA, HEADER))
+
+
+if __name__ == '__main__':
+    unittest.main()
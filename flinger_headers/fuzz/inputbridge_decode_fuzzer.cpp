@@ -0,0 +1,166 @@
+/*
+ * Copyright 2026 The Chromium Authors.
+ *
+ * Permission is hereby granted, free of charge, to any person obtaining a
+ * copy of this software and associated documentation files (the "Software"),
+ * to deal in the Software without restriction, including without limitation
+ * the rights to use, copy, modify, merge, publish, distribute, sublicense,
+ * and/or sell copies of the Software, and to permit persons to whom the
+ * Software is furnished to do so, subject to the following conditions:
+ *
+ * The above copyright notice and this permission notice (including the next
+ * paragraph) shall be included in all copies or substantial portions of the
+ * Software.
+ *
+ * THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+ * IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+ * FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL
+ * THE AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+ * LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING
+ * FROM, OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER
+ * DEALINGS IN THE SOFTWARE.
+ */
+
+// libFuzzer harness for the consumer side of kArcInputBridgePipe.
+//
+// The input is read as a stream of raw legacy BridgeInputEvents, as a stream
+// of compact records, and through BridgeInputStreamDecoder, which follows
+// WIRE_FORMAT switches and keeps METADATA the way a consumer does. Every event
+// that ValidateBridgeInputEvent accepts is then consumed the way a consumer
+// would: dispatched with every field of its args read, names read as C
+// strings, gamepad snapshots expanded, and the compact encoding round-tripped.
+// Run under ASan and UBSan, any event the validator lets through that a
+// consumer can't safely read shows up as a sanitizer report.
+
+#include <cstddef>
+#include <cstdint>
+#include <cstdlib>
+#include <cstring>
+#include <vector>
+
+#include "ArcInputBridgeDispatcher.h"
+#include "ArcInputBridgeGamepadSnapshot.h"
+#include "ArcInputBridgeProtocol.h"
+#include "ArcInputBridgeStream.h"
+#include "ArcInputBridgeValidator.h"
+
+namespace arc {
+namespace {
+
+// Reads every field a consumer may read for each args struct.
+struct ReadEverything {
+    uint64_t sum = 0;
+    double values = 0;
+
+    template <InputEventType Type>
+    void operator()(InputEventTag<Type>, const BridgeInputEvent& event, const NoArgs&) {
+        sum += event.timestamp;
+    }
+    template <InputEventType Type>
+    void operator()(InputEventTag<Type>, const BridgeInputEvent&, const PointerArgs& args) {
+        values += args.x + args.y;
+        sum += args.discrete;
+    }
+    template <InputEventType Type>
+    void operator()(InputEventTag<Type>, const BridgeInputEvent&, const TouchArgs& args) {
+        if (Type == InputEventType::TOUCH_TOOL_TYPE) {
+            sum += static_cast<uint8_t>(args.tool);
+        } else if (Type == InputEventType::TOUCH_SHAPE) {
+            values += args.major + args.minor;
+        } else if (Type == InputEventType::TOUCH_FORCE) {
+            values += args.force;
+        } else {
+            values += args.x + args.y;
+        }
+    }
+    template <InputEventType Type>
+    void operator()(InputEventTag<Type>, const BridgeInputEvent&, const GestureArgs& args) {
+        sum += args.fingers;
+        sum += args.cancelled;
+    }
+    template <InputEventType Type>
+    void operator()(InputEventTag<Type>, const BridgeInputEvent&, const GamepadArgs& args) {
+        sum += args.id;
+        sum += args.button;
+        sum += args.pressed;
+        values += args.value;
+    }
+    template <InputEventType Type>
+    void operator()(InputEventTag<Type>, const BridgeInputEvent&,
+                    const GamepadDeviceInfoArgs& args) {
+        sum += strlen(args.name);
+    }
+    template <InputEventType Type>
+    void operator()(InputEventTag<Type>, const BridgeInputEvent&,
+                    const KeyCharacterMapNameArgs& args) {
+        sum += strlen(args.name);
+    }
+    template <InputEventType Type>
+    void operator()(InputEventTag<Type>, const BridgeInputEvent& event,
+                    const GamepadSnapshotArgs& args) {
+        sum += args.endsFrame;
+        std::vector<BridgeInputEvent> expanded;
+        ExpandGamepadSnapshot(event, &expanded);
+        for (const BridgeInputEvent& axisOrButton : expanded) {
+            sum += axisOrButton.gamepad.pressed;
+            values += axisOrButton.gamepad.value;
+        }
+    }
+    // Structs without bools, enums or strings: any bit pattern is fine.
+    template <InputEventType Type, typename Args>
+    void operator()(InputEventTag<Type>, const BridgeInputEvent&, const Args& args) {
+        uint8_t bytes[sizeof(Args)];
+        memcpy(bytes, &args, sizeof(args));
+        for (uint8_t byte : bytes) {
+            sum += byte;
+        }
+    }
+};
+
+void Consume(const BridgeInputEvent& event) {
+    if (ValidateBridgeInputEvent(event) != BridgeInputEventError::NONE) {
+        return;
+    }
+    ReadEverything reader;
+    DispatchBridgeInputEvent(event, reader);
+
+    uint8_t encoded[BridgeInputEvent::kMaxCompactSize];
+    size_t length = event.EncodeCompact(encoded, sizeof(encoded));
+    BridgeInputEvent decoded;
+    if (length == 0 || BridgeInputEvent::DecodeCompact(encoded, length, &decoded) != length ||
+        decoded.CompactSize() != length ||
+        ValidateBridgeInputEvent(decoded) != BridgeInputEventError::NONE) {
+        abort();
+    }
+}
+
+}  // namespace
+}  // namespace arc
+
+extern "C" int LLVMFuzzerTestOneInput(const uint8_t* data, size_t size) {
+    using namespace arc;
+    BridgeInputEvent event;
+    for (size_t offset = 0; offset + sizeof(event) <= size; offset += sizeof(event)) {
+        if (DecodeBridgeInputEvent(data + offset, size - offset, &event) ==
+            BridgeInputEventError::NONE) {
+            Consume(event);
+        }
+    }
+    size_t offset = 0;
+    while (size_t consumed =
+                   BridgeInputEvent::DecodeCompact(data + offset, size - offset, &event)) {
+        Consume(event);
+        offset += consumed;
+    }
+    BridgeInputStreamDecoder decoder;
+    for (offset = 0; offset < size;) {
+        offset += decoder.Append(data + offset, size - offset);
+        while (decoder.Next(&event)) {
+            Consume(event);
+        }
+        if (decoder.corrupt()) {
+            break;
+        }
+    }
+    return 0;
+}
@@ -65,6 +65,24 @@ typedef enum {
 
     // For HWC2_ARC_PRIVATE_CAPABILITY_ATTRIBUTES
     HWC2_ARC_PRIVATE_FUNCTION_ATTRIBUTES_SHOULD_FORCE_UPDATE,
+
+    // For HWC2_ARC_PRIVATE_CAPABILITY_ATTRIBUTES
+    HWC2_ARC_PRIVATE_FUNCTION_SET_LAYER_ATTRIBUTES_BATCH,
+
+    // For HWC2_ARC_PRIVATE_CAPABILITY_ATTRIBUTES
+    HWC2_ARC_PRIVATE_FUNCTION_GET_LAYER_ATTRIBUTES_GENERATION,
+
+    // For HWC2_ARC_PRIVATE_CAPABILITY_ATTRIBUTES
+    HWC2_ARC_PRIVATE_FUNCTION_SET_LAYER_ATTRIBUTES_GENERATION,
+
+    // For HWC2_ARC_PRIVATE_CAPABILITY_ATTRIBUTES
+    HWC2_ARC_PRIVATE_FUNCTION_SET_LAYER_ATTRIBUTES_AND_SHOULD_FORCE_UPDATE,
+
+    // For HWC2_ARC_PRIVATE_CAPABILITY_ATTRIBUTES
+    HWC2_ARC_PRIVATE_FUNCTION_ALLOCATE_ATTRIBUTE_STORAGE,
+
+    // For HWC2_ARC_PRIVATE_CAPABILITY_WINDOWING_COMPOSER
+    HWC2_ARC_PRIVATE_FUNCTION_SET_LAYER_HIDDEN_BATCH,
 } hwc2_arc_private_function_descriptor_t;
 
 typedef enum {
@@ -78,6 +96,22 @@ typedef enum {
     HWC2_ARC_PRIVATE_HIDDEN_DISABLE = 2,
 } hwc2_arc_private_hidden_t;
 
+/* A layer in an arcSetLayerAttributesBatch call. Its attributes are the
+ * numElements entries of the attribute array starting at firstElement. */
+typedef struct hwc2_arc_private_layer_attributes {
+    hwc2_layer_t layer;
+    uint32_t firstElement;
+    uint32_t numElements;
+} hwc2_arc_private_layer_attributes_t;
+
+/* An attribute in an arcSetLayerAttributesBatch call. Its value is the size
+ * bytes at offset in the values buffer. */
+typedef struct hwc2_arc_private_attribute {
+    int32_t id;
+    uint32_t size;
+    uint32_t offset;
+} hwc2_arc_private_attribute_t;
+
 /*
  * Stringification Functions
  */
@@ -112,6 +146,18 @@ static inline const char* getArcPrivateFunctionDescriptorName(
         return "ArcSetLayerHidden";
     case HWC2_ARC_PRIVATE_FUNCTION_ATTRIBUTES_SHOULD_FORCE_UPDATE:
         return "ArcAttributesShouldForceUpdate";
+    case HWC2_ARC_PRIVATE_FUNCTION_SET_LAYER_ATTRIBUTES_BATCH:
+        return "ArcSetLayerAttributesBatch";
+    case HWC2_ARC_PRIVATE_FUNCTION_GET_LAYER_ATTRIBUTES_GENERATION:
+        return "ArcGetLayerAttributesGeneration";
+    case HWC2_ARC_PRIVATE_FUNCTION_SET_LAYER_ATTRIBUTES_GENERATION:
+        return "ArcSetLayerAttributesGeneration";
+    case HWC2_ARC_PRIVATE_FUNCTION_SET_LAYER_ATTRIBUTES_AND_SHOULD_FORCE_UPDATE:
+        return "ArcSetLayerAttributesAndShouldForceUpdate";
+    case HWC2_ARC_PRIVATE_FUNCTION_ALLOCATE_ATTRIBUTE_STORAGE:
+        return "ArcAllocateAttributeStorage";
+    case HWC2_ARC_PRIVATE_FUNCTION_SET_LAYER_HIDDEN_BATCH:
+        return "ArcSetLayerHiddenBatch";
     default:
         return "Unknown";
     }
@@ -173,6 +219,13 @@ enum class ArcPrivateFunctionDescriptor : int32_t {
     SetLayerAttributes = HWC2_ARC_PRIVATE_FUNCTION_SET_LAYER_ATTRIBUTES,
     SetLayerHidden = HWC2_ARC_PRIVATE_FUNCTION_SET_LAYER_HIDDEN,
     AttributesShouldForceUpdate = HWC2_ARC_PRIVATE_FUNCTION_ATTRIBUTES_SHOULD_FORCE_UPDATE,
+    SetLayerAttributesBatch = HWC2_ARC_PRIVATE_FUNCTION_SET_LAYER_ATTRIBUTES_BATCH,
+    GetLayerAttributesGeneration = HWC2_ARC_PRIVATE_FUNCTION_GET_LAYER_ATTRIBUTES_GENERATION,
+    SetLayerAttributesGeneration = HWC2_ARC_PRIVATE_FUNCTION_SET_LAYER_ATTRIBUTES_GENERATION,
+    SetLayerAttributesAndShouldForceUpdate =
+            HWC2_ARC_PRIVATE_FUNCTION_SET_LAYER_ATTRIBUTES_AND_SHOULD_FORCE_UPDATE,
+    AllocateAttributeStorage = HWC2_ARC_PRIVATE_FUNCTION_ALLOCATE_ATTRIBUTE_STORAGE,
+    SetLayerHiddenBatch = HWC2_ARC_PRIVATE_FUNCTION_SET_LAYER_HIDDEN_BATCH,
 };
 TO_STRING(hwc2_arc_private_function_descriptor_t, ArcPrivateFunctionDescriptor,
         getArcPrivateFunctionDescriptorName)
@@ -243,6 +296,94 @@ typedef void (*HWC2_ARC_PRIVATE_PFN_GET_CAPABILITIES)(hwc2_device_t* device, uin
 typedef int32_t /*hwc2_error_t*/ (*HWC2_ARC_PRIVATE_PFN_GET_DISPLAY_ATTRIBUTE)(
         hwc2_device_t* device, hwc2_display_t display, const int32_t attribute, int32_t* outValue);
 
+/* arcSetLayerAttributesBatch(..., numLayers, layers, numElements, attributes,
+ *         valuesSize, values)
+ * Descriptor: HWC2_ARC_PRIVATE_FUNCTION_SET_LAYER_ATTRIBUTES_BATCH
+ * Provided by HWC2 devices which support
+ * HWC2_ARC_PRIVATE_CAPABILITY_ATTRIBUTES
+ *
+ * Sets the attributes of any number of layers of the display in one call. The
+ * effect is the same as calling arcSetLayerAttributes once per entry of
+ * layers, but all attributes travel in one flattened buffer and the whole
+ * batch is validated up front: if any entry is invalid, no layer is changed.
+ *
+ * Parameters:
+ *   numLayers - the number of elements in layers
+ *   layers - the layers to set attributes on, each with the range of
+ *       attributes that belongs to it
+ *   numElements - the number of elements in attributes
+ *   attributes - the attribute ids, sizes and value offsets of all layers
+ *   valuesSize - the size in bytes of values
+ *   values - the data of all attribute values
+ *
+ * Returns HWC2_ERROR_NONE or one of the following errors:
+ *   HWC2_ERROR_BAD_DISPLAY - an invalid display handle was passed in
+ *   HWC2_ERROR_BAD_LAYER - an invalid layer handle was passed in
+ *   HWC2_ERROR_BAD_PARAMETER - an attribute range lies outside attributes, or
+ *       a value lies outside values
+ */
+typedef int32_t /*hwc2_error_t*/ (*HWC2_ARC_PRIVATE_PFN_SET_LAYER_ATTRIBUTES_BATCH)(
+        hwc2_device_t* device, hwc2_display_t display, uint32_t numLayers,
+        const hwc2_arc_private_layer_attributes_t* layers, uint32_t numElements,
+        const hwc2_arc_private_attribute_t* attributes, uint32_t valuesSize,
+        const uint8_t* values);
+
+/* arcAllocateAttributeStorage(..., size, outData)
+ * Descriptor: HWC2_ARC_PRIVATE_FUNCTION_ALLOCATE_ATTRIBUTE_STORAGE
+ * Provided by HWC2 devices which support
+ * HWC2_ARC_PRIVATE_CAPABILITY_ATTRIBUTES
+ *
+ * Allocates device owned storage for attribute values of the frame being
+ * prepared on the display, so that values can be passed to the device without
+ * a copy on either side.
+ *
+ * The framework writes values into the storage and passes pointers into it to
+ * the arcSetLayerAttributes functions of this display, after which it must
+ * not modify it again. The device does not copy values that lie in this
+ * storage: it may reference them until presentDisplay returns for the frame
+ * after the one they were allocated for, and then reuses the storage. Values
+ * the device needs for longer must be copied or decoded by then. Values passed
+ * from anywhere else are still only valid for the duration of the call.
+ *
+ * Parameters:
+ *   size - the number of bytes to allocate
+ *   outData - the storage, aligned to 8 bytes; pointer will be non-NULL
+ *
+ * Returns HWC2_ERROR_NONE or one of the following errors:
+ *   HWC2_ERROR_BAD_DISPLAY - an invalid display handle was passed in
+ *   HWC2_ERROR_NO_RESOURCES - the storage could not be allocated
+ */
+typedef int32_t /*hwc2_error_t*/ (*HWC2_ARC_PRIVATE_PFN_ALLOCATE_ATTRIBUTE_STORAGE)(
+        hwc2_device_t* device, hwc2_display_t display, uint32_t size, uint8_t** outData);
+
+/* arcSetLayerHiddenBatch(..., numLayers, layers, hiddenBitmap)
+ * Descriptor: HWC2_ARC_PRIVATE_FUNCTION_SET_LAYER_HIDDEN_BATCH
+ * Provided by HWC2 devices which support
+ * HWC2_ARC_PRIVATE_CAPABILITY_WINDOWING_COMPOSER
+ *
+ * Indicates for several layers of the display at once whether they should be
+ * hidden, e.g. when the window manager minimizes or restores a whole task
+ * stack. The effect is the same as calling arcSetLayerHidden for each layer,
+ * except that the change is atomic: if any layer handle is invalid no layer is
+ * changed, and the device must never compose a frame in which only some of
+ * the layers have changed.
+ *
+ * Parameters:
+ *   numLayers - the number of elements in layers
+ *   layers - the layers to change
+ *   hiddenBitmap - (numLayers + 7) / 8 bytes holding one bit per layer, least
+ *       significant bit first: bit (i % 8) of byte (i / 8) is set if layers[i]
+ *       should be hidden (HWC2_ARC_PRIVATE_HIDDEN_ENABLE) and clear if it
+ *       should be shown (HWC2_ARC_PRIVATE_HIDDEN_DISABLE)
+ *
+ * Returns HWC2_ERROR_NONE or one of the following errors:
+ *   HWC2_ERROR_BAD_DISPLAY - an invalid display handle was passed in
+ *   HWC2_ERROR_BAD_LAYER - an invalid layer handle was passed in
+ */
+typedef int32_t /*hwc2_error_t*/ (*HWC2_ARC_PRIVATE_PFN_SET_LAYER_HIDDEN_BATCH)(
+        hwc2_device_t* device, hwc2_display_t display, uint32_t numLayers,
+        const hwc2_layer_t* layers, const uint8_t* hiddenBitmap);
+
 /*
  * ARC Private layer Functions
  *
@@ -276,6 +417,49 @@ typedef int32_t /*hwc2_error_t*/ (*HWC2_ARC_PRIVATE_PFN_SET_LAYER_ATTRIBUTES)(hw
         hwc2_display_t display, hwc2_layer_t layer, uint32_t numElements, const int32_t* ids,
         const uint32_t* sizes, const uint8_t** values);
 
+/* arcGetLayerAttributesGeneration(..., outGeneration)
+ * Descriptor: HWC2_ARC_PRIVATE_FUNCTION_GET_LAYER_ATTRIBUTES_GENERATION
+ * Provided by HWC2 devices which support
+ * HWC2_ARC_PRIVATE_CAPABILITY_ATTRIBUTES
+ *
+ * Gets the generation last recorded with arcSetLayerAttributesGeneration.
+ *
+ * The framework keeps a generation per layer that it bumps whenever the
+ * layer's attributes change. As long as the device reports the framework's
+ * current generation it holds up to date attributes, and the framework may
+ * skip arcSetLayerAttributes for the layer. The framework only needs to query
+ * this when it can't tell what the device holds, e.g. for a reused layer.
+ *
+ * Parameters:
+ *   outGeneration - the generation, or 0 if none was recorded since the
+ *       layer was created; pointer will be non-NULL
+ *
+ * Returns HWC2_ERROR_NONE or one of the following errors:
+ *   HWC2_ERROR_BAD_LAYER - an invalid layer handle was passed in
+ */
+typedef int32_t /*hwc2_error_t*/ (*HWC2_ARC_PRIVATE_PFN_GET_LAYER_ATTRIBUTES_GENERATION)(
+        hwc2_device_t* device, hwc2_display_t display, hwc2_layer_t layer,
+        uint64_t* outGeneration);
+
+/* arcSetLayerAttributesGeneration(..., generation)
+ * Descriptor: HWC2_ARC_PRIVATE_FUNCTION_SET_LAYER_ATTRIBUTES_GENERATION
+ * Provided by HWC2 devices which support
+ * HWC2_ARC_PRIVATE_CAPABILITY_ATTRIBUTES
+ *
+ * Records the framework's generation of the attributes that were just set on
+ * the layer. See arcGetLayerAttributesGeneration.
+ *
+ * Parameters:
+ *   generation - the generation; must not be 0
+ *
+ * Returns HWC2_ERROR_NONE or one of the following errors:
+ *   HWC2_ERROR_BAD_LAYER - an invalid layer handle was passed in
+ *   HWC2_ERROR_BAD_PARAMETER - generation was 0
+ */
+typedef int32_t /*hwc2_error_t*/ (*HWC2_ARC_PRIVATE_PFN_SET_LAYER_ATTRIBUTES_GENERATION)(
+        hwc2_device_t* device, hwc2_display_t display, hwc2_layer_t layer,
+        uint64_t generation);
+
 /* arcSetLayerHidden(..., hidden)
  * Descriptor: HWC2_ARC_PRIVATE_FUNCTION_SET_LAYER_HIDDEN
  * Provided by HWC2 devices which support
@@ -302,6 +486,11 @@ typedef int32_t /*hwc2_error_t*/ (*HWC2_ARC_PRIVATE_PFN_SET_LAYER_HIDDEN)(
  * Outputs to |outShouldForceUpdate| whether to send geometry updates without
  * waiting for a matching buffer, given the specified layer attributes.
  *
+ * The framework calls this with the attributes it has just set with
+ * arcSetLayerAttributes, so the device should compute the decision once when
+ * the attributes are set and answer from it here rather than decode them
+ * again. Use arcSetLayerAttributesAndShouldForceUpdate to do both in one call.
+ *
  * Parameters:
  *   numElements - the number of elements in each array.
  *   ids - an array of surface attribute ids
@@ -318,6 +507,32 @@ typedef int32_t /*hwc2_error_t*/ (*HWC2_ARC_PRIVATE_PFN_ATTRIBUTES_SHOULD_FORCE_
     uint32_t numElements, const int32_t* ids, const uint32_t* sizes,
     const uint8_t** values, bool* outShouldForceUpdate);
 
+/* arcSetLayerAttributesAndShouldForceUpdate(..., numElements, ids, sizes, values,
+ *         outShouldForceUpdate)
+ * Descriptor: HWC2_ARC_PRIVATE_FUNCTION_SET_LAYER_ATTRIBUTES_AND_SHOULD_FORCE_UPDATE
+ * Provided by HWC2 devices which support
+ * HWC2_ARC_PRIVATE_CAPABILITY_ATTRIBUTES
+ *
+ * Combines arcSetLayerAttributes and arcAttributesShouldForceUpdate: sets the
+ * attributes and outputs whether to send geometry updates without waiting for
+ * a matching buffer, decoding the attributes only once.
+ *
+ * Parameters:
+ *   numElements - the number of elements in each array.
+ *   ids - an array of surface attribute ids
+ *   sizes - an array of sizes, giving the size in bytes of each value
+ *   values - an array of pointers to the data for each value
+ *   outShouldForceUpdate - whether to send geometry updates without waiting
+ *      for a matching buffer
+ *
+ * Returns HWC2_ERROR_NONE or one of the following errors:
+ *   HWC2_ERROR_BAD_LAYER - an invalid layer handle was passed in
+ */
+typedef int32_t /*hwc2_error_t*/ (*HWC2_ARC_PRIVATE_PFN_SET_LAYER_ATTRIBUTES_AND_SHOULD_FORCE_UPDATE)(
+    hwc2_device_t* device, hwc2_display_t display, hwc2_layer_t layer,
+    uint32_t numElements, const int32_t* ids, const uint32_t* sizes,
+    const uint8_t** values, bool* outShouldForceUpdate);
+
 __END_DECLS
 
 #endif
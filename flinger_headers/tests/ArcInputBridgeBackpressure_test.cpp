@@ -0,0 +1,246 @@
+/*
+ * Copyright 2026 The Chromium Authors.
+ *
+ * Permission is hereby granted, free of charge, to any person obtaining a
+ * copy of this software and associated documentation files (the "Software"),
+ * to deal in the Software without restriction, including without limitation
+ * the rights to use, copy, modify, merge, publish, distribute, sublicense,
+ * and/or sell copies of the Software, and to permit persons to whom the
+ * Software is furnished to do so, subject to the following conditions:
+ *
+ * The above copyright notice and this permission notice (including the next
+ * paragraph) shall be included in all copies or substantial portions of the
+ * Software.
+ *
+ * THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+ * IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+ * FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL
+ * THE AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+ * LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING
+ * FROM, OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER
+ * DEALINGS IN THE SOFTWARE.
+ */
+
+#include <fcntl.h>
+#include <signal.h>
+#include <unistd.h>
+
+#include <cerrno>
+#include <cstdint>
+#include <memory>
+#include <vector>
+
+#include <gtest/gtest.h>
+
+#include "ArcInputBridgeBackpressure.h"
+
+namespace arc {
+namespace {
+
+BridgeInputEvent Move(float x) {
+    return BridgeInputEvent::PointerEvent(0, InputEventType::POINTER_MOVE, x, 0);
+}
+
+BridgeInputEvent RelativeMove(float dx) {
+    BridgeInputEvent event = {};
+    event.type = InputEventType::POINTER_MOVE_RELATIVE;
+    event.relativePointer.dx = dx;
+    return event;
+}
+
+BridgeInputEvent Frame() {
+    return BridgeInputEvent::PointerEvent(0, InputEventType::POINTER_FRAME);
+}
+
+BridgeInputEvent Button() {
+    return BridgeInputEvent::PointerButtonEvent(0, 0x110, 1);
+}
+
+BridgeInputEvent Key(uint32_t serial) {
+    return BridgeInputEvent::KeyEvent(0, 30, 1, serial);
+}
+
+// Runs the writer against a pipe that is already full, so that everything it
+// is given stays queued until Drain().
+class ArcInputBridgeBackpressureTest : public testing::Test {
+protected:
+    void SetUp() override {
+        ASSERT_EQ(0, pipe2(mFds, O_CLOEXEC | O_NONBLOCK));
+        uint8_t junk[4096] = {};
+        for (size_t chunk = sizeof(junk); chunk > 0; chunk /= 2) {
+            ssize_t n;
+            while ((n = write(mFds[1], junk, chunk)) > 0) {
+                mJunk += n;
+            }
+            ASSERT_EQ(EAGAIN, errno);
+        }
+    }
+
+    void TearDown() override {
+        close(mFds[0]);
+        close(mFds[1]);
+    }
+
+    std::unique_ptr<BridgeInputBackpressureWriter> MakeWriter(BridgeInputOverflowPolicy policy) {
+        BridgeInputBackpressureWriter::Options options;
+        options.capacity = 4;
+        options.policy = policy;
+        return std::make_unique<BridgeInputBackpressureWriter>(mFds[1], options);
+    }
+
+    // Empties the pipe and returns everything the writer still had queued.
+    std::vector<BridgeInputEvent> Drain(BridgeInputBackpressureWriter* writer) {
+        std::vector<uint8_t> junk(mJunk);
+        EXPECT_EQ(static_cast<ssize_t>(mJunk), read(mFds[0], junk.data(), junk.size()));
+        mJunk = 0;
+        std::vector<BridgeInputEvent> events;
+        while (writer->HasPending()) {
+            EXPECT_TRUE(writer->Flush());
+            BridgeInputEvent event;
+            while (read(mFds[0], &event, sizeof(event)) == sizeof(event)) {
+                events.push_back(event);
+            }
+        }
+        return events;
+    }
+
+    static std::vector<InputEventType> Types(const std::vector<BridgeInputEvent>& events) {
+        std::vector<InputEventType> types;
+        for (const BridgeInputEvent& event : events) {
+            types.push_back(event.type);
+        }
+        return types;
+    }
+
+    int mFds[2] = {-1, -1};
+    size_t mJunk = 0;
+};
+
+TEST_F(ArcInputBridgeBackpressureTest, QueuesWhilePipeIsFull) {
+    auto writer = MakeWriter(BridgeInputOverflowPolicy::DROP_OLDEST_MOVES);
+    EXPECT_TRUE(writer->Write(Key(1)));
+    EXPECT_TRUE(writer->HasPending());
+    std::vector<BridgeInputEvent> events = Drain(writer.get());
+    ASSERT_EQ(1u, events.size());
+    EXPECT_EQ(1u, events[0].key.serial);
+    EXPECT_EQ(1u, writer->stats().written);
+}
+
+TEST_F(ArcInputBridgeBackpressureTest, DropOldestMovesDropsSupersededMove) {
+    auto writer = MakeWriter(BridgeInputOverflowPolicy::DROP_OLDEST_MOVES);
+    for (const BridgeInputEvent& event : {Move(1), Frame(), Move(2), Frame(), Move(3)}) {
+        ASSERT_TRUE(writer->Write(event));
+    }
+    std::vector<BridgeInputEvent> events = Drain(writer.get());
+    ASSERT_EQ(4u, events.size());
+    EXPECT_EQ(InputEventType::POINTER_FRAME, events[0].type);
+    EXPECT_EQ(2, events[1].pointer.x);
+    EXPECT_EQ(3, events[3].pointer.x);
+    EXPECT_EQ(1u, writer->stats().droppedMoves);
+    EXPECT_FALSE(writer->TakeResyncRequest());
+}
+
+TEST_F(ArcInputBridgeBackpressureTest, DropOldestMovesStopsAtBarrier) {
+    auto writer = MakeWriter(BridgeInputOverflowPolicy::DROP_OLDEST_MOVES);
+    for (const BridgeInputEvent& event : {Move(1), Button(), Move(2), Frame(), Move(3)}) {
+        ASSERT_TRUE(writer->Write(event));
+    }
+    // Move(1) has no successor before the button; Move(2) is superseded by
+    // the incoming Move(3).
+    std::vector<BridgeInputEvent> events = Drain(writer.get());
+    ASSERT_EQ(4u, events.size());
+    EXPECT_EQ(1, events[0].pointer.x);
+    EXPECT_EQ(InputEventType::POINTER_BUTTON, events[1].type);
+    EXPECT_EQ(InputEventType::POINTER_FRAME, events[2].type);
+    EXPECT_EQ(3, events[3].pointer.x);
+}
+
+TEST_F(ArcInputBridgeBackpressureTest, DropOldestMovesMergesRelativeMoves) {
+    auto writer = MakeWriter(BridgeInputOverflowPolicy::DROP_OLDEST_MOVES);
+    for (const BridgeInputEvent& event :
+         {RelativeMove(1), Frame(), RelativeMove(2), Frame(), RelativeMove(4)}) {
+        ASSERT_TRUE(writer->Write(event));
+    }
+    std::vector<BridgeInputEvent> events = Drain(writer.get());
+    ASSERT_EQ(4u, events.size());
+    EXPECT_EQ(3, events[1].relativePointer.dx);
+    EXPECT_EQ(4, events[3].relativePointer.dx);
+}
+
+TEST_F(ArcInputBridgeBackpressureTest, DropOldestMovesDropsEmptyFrame) {
+    auto writer = MakeWriter(BridgeInputOverflowPolicy::DROP_OLDEST_MOVES);
+    for (const BridgeInputEvent& event : {Move(1), Frame(), Key(1), Frame(), Key(2)}) {
+        ASSERT_TRUE(writer->Write(event));
+    }
+    EXPECT_EQ(std::vector<InputEventType>({InputEventType::POINTER_MOVE,
+                                           InputEventType::POINTER_FRAME, InputEventType::KEY,
+                                           InputEventType::KEY}),
+              Types(Drain(writer.get())));
+    EXPECT_EQ(1u, writer->stats().droppedEmptyFrames);
+}
+
+TEST_F(ArcInputBridgeBackpressureTest, DropOldestMovesResetsWhenNothingCanGo) {
+    auto writer = MakeWriter(BridgeInputOverflowPolicy::DROP_OLDEST_MOVES);
+    for (uint32_t serial = 1; serial <= 5; serial++) {
+        ASSERT_TRUE(writer->Write(Key(serial)));
+    }
+    std::vector<BridgeInputEvent> events = Drain(writer.get());
+    ASSERT_EQ(2u, events.size());
+    EXPECT_EQ(InputEventType::RESET, events[0].type);
+    EXPECT_EQ(5u, events[1].key.serial);
+    EXPECT_EQ(1u, writer->stats().resets);
+    EXPECT_EQ(4u, writer->stats().droppedOnReset);
+    EXPECT_TRUE(writer->TakeResyncRequest());
+    EXPECT_FALSE(writer->TakeResyncRequest());
+}
+
+TEST_F(ArcInputBridgeBackpressureTest, CoalesceFoldsMoveOnlyFrames) {
+    auto writer = MakeWriter(BridgeInputOverflowPolicy::COALESCE);
+    for (const BridgeInputEvent& event : {Move(1), Frame(), Move(2), Frame(), Move(3)}) {
+        ASSERT_TRUE(writer->Write(event));
+    }
+    std::vector<BridgeInputEvent> events = Drain(writer.get());
+    ASSERT_EQ(3u, events.size());
+    EXPECT_EQ(2, events[0].pointer.x);
+    EXPECT_EQ(InputEventType::POINTER_FRAME, events[1].type);
+    EXPECT_EQ(3, events[2].pointer.x);
+    EXPECT_EQ(2u, writer->stats().coalescedEvents);
+    EXPECT_FALSE(writer->TakeResyncRequest());
+}
+
+TEST_F(ArcInputBridgeBackpressureTest, CoalesceResetsWhenNothingFolds) {
+    auto writer = MakeWriter(BridgeInputOverflowPolicy::COALESCE);
+    for (uint32_t serial = 1; serial <= 5; serial++) {
+        ASSERT_TRUE(writer->Write(Key(serial)));
+    }
+    EXPECT_EQ(std::vector<InputEventType>({InputEventType::RESET, InputEventType::KEY}),
+              Types(Drain(writer.get())));
+    EXPECT_TRUE(writer->TakeResyncRequest());
+}
+
+TEST_F(ArcInputBridgeBackpressureTest, ResetDiscardsQueue) {
+    auto writer = MakeWriter(BridgeInputOverflowPolicy::RESET);
+    for (const BridgeInputEvent& event : {Move(1), Frame(), Move(2), Frame(), Move(3)}) {
+        ASSERT_TRUE(writer->Write(event));
+    }
+    std::vector<BridgeInputEvent> events = Drain(writer.get());
+    ASSERT_EQ(2u, events.size());
+    EXPECT_EQ(InputEventType::RESET, events[0].type);
+    EXPECT_EQ(3, events[1].pointer.x);
+    EXPECT_EQ(4u, writer->stats().droppedOnReset);
+    EXPECT_TRUE(writer->TakeResyncRequest());
+}
+
+TEST_F(ArcInputBridgeBackpressureTest, ReportsBrokenPipe) {
+    auto writer = MakeWriter(BridgeInputOverflowPolicy::DROP_OLDEST_MOVES);
+    ASSERT_TRUE(writer->Write(Key(1)));
+    close(mFds[0]);
+    mFds[0] = -1;
+    // Pipes have no MSG_NOSIGNAL; the owner ignores SIGPIPE.
+    sighandler_t previous = signal(SIGPIPE, SIG_IGN);
+    EXPECT_FALSE(writer->Flush());
+    signal(SIGPIPE, previous);
+}
+
+}  // namespace
+}  // namespace arc
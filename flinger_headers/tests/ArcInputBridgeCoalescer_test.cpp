@@ -0,0 +1,158 @@
+/*
+ * Copyright 2026 The Chromium Authors.
+ *
+ * Permission is hereby granted, free of charge, to any person obtaining a
+ * copy of this software and associated documentation files (the "Software"),
+ * to deal in the Software without restriction, including without limitation
+ * the rights to use, copy, modify, merge, publish, distribute, sublicense,
+ * and/or sell copies of the Software, and to permit persons to whom the
+ * Software is furnished to do so, subject to the following conditions:
+ *
+ * The above copyright notice and this permission notice (including the next
+ * paragraph) shall be included in all copies or substantial portions of the
+ * Software.
+ *
+ * THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+ * IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+ * FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL
+ * THE AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+ * LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING
+ * FROM, OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER
+ * DEALINGS IN THE SOFTWARE.
+ */
+
+#include <cstdint>
+#include <vector>
+
+#include <gtest/gtest.h>
+
+#include "ArcInputBridgeCoalescer.h"
+
+namespace arc {
+namespace {
+
+BridgeInputEvent Move(float x, int32_t displayId = 0) {
+    BridgeInputEvent event = BridgeInputEvent::PointerEvent(0, InputEventType::POINTER_MOVE, x, 0);
+    event.displayId = displayId;
+    return event;
+}
+
+BridgeInputEvent RelativeMove(float dx) {
+    BridgeInputEvent event = {};
+    event.type = InputEventType::POINTER_MOVE_RELATIVE;
+    event.relativePointer.dx = dx;
+    return event;
+}
+
+BridgeInputEvent TouchMove(int32_t id, float x) {
+    BridgeInputEvent event = {};
+    event.type = InputEventType::TOUCH_MOVE;
+    event.touch.id = id;
+    event.touch.x = x;
+    return event;
+}
+
+BridgeInputEvent Frame(InputEventType type = InputEventType::POINTER_FRAME) {
+    BridgeInputEvent event = {};
+    event.type = type;
+    return event;
+}
+
+BridgeInputEvent TouchFrame() {
+    return Frame(InputEventType::TOUCH_FRAME);
+}
+
+BridgeInputEvent Button() {
+    return BridgeInputEvent::PointerButtonEvent(0, 0x110, 1);
+}
+
+std::vector<BridgeInputEvent> Coalesce(std::vector<BridgeInputEvent> events,
+                                       bool foldMoveOnlyFrames = false) {
+    BridgeInputCoalescer::Options options;
+    options.foldMoveOnlyFrames = foldMoveOnlyFrames;
+    BridgeInputCoalescer coalescer(options);
+    events.resize(coalescer.Coalesce(events.data(), events.size()));
+    return events;
+}
+
+std::vector<InputEventType> Types(const std::vector<BridgeInputEvent>& events) {
+    std::vector<InputEventType> types;
+    for (const BridgeInputEvent& event : events) {
+        types.push_back(event.type);
+    }
+    return types;
+}
+
+TEST(ArcInputBridgeCoalescerTest, KeepsNewestPointerMove) {
+    std::vector<BridgeInputEvent> out = Coalesce({Move(1), Move(2), Move(3), Frame()});
+    ASSERT_EQ(2u, out.size());
+    EXPECT_EQ(3, out[0].pointer.x);
+    EXPECT_EQ(InputEventType::POINTER_FRAME, out[1].type);
+}
+
+TEST(ArcInputBridgeCoalescerTest, SumsRelativeMoves) {
+    std::vector<BridgeInputEvent> out = Coalesce({RelativeMove(1), RelativeMove(2), Frame()});
+    ASSERT_EQ(2u, out.size());
+    EXPECT_EQ(3, out[0].relativePointer.dx);
+}
+
+TEST(ArcInputBridgeCoalescerTest, FoldsTouchMovesPerContact) {
+    std::vector<BridgeInputEvent> out =
+            Coalesce({TouchMove(0, 1), TouchMove(1, 10), TouchMove(0, 2), TouchFrame()});
+    ASSERT_EQ(3u, out.size());
+    EXPECT_EQ(0, out[0].touch.id);
+    EXPECT_EQ(2, out[0].touch.x);
+    EXPECT_EQ(1, out[1].touch.id);
+    EXPECT_EQ(10, out[1].touch.x);
+}
+
+TEST(ArcInputBridgeCoalescerTest, KeepsMovesOfOtherDisplays) {
+    EXPECT_EQ(3u, Coalesce({Move(1, 0), Move(2, 1), Frame()}).size());
+}
+
+TEST(ArcInputBridgeCoalescerTest, ButtonIsBarrier) {
+    std::vector<BridgeInputEvent> out = Coalesce({Move(1), Button(), Move(2), Frame()});
+    ASSERT_EQ(4u, out.size());
+    EXPECT_EQ(1, out[0].pointer.x);
+    EXPECT_EQ(2, out[2].pointer.x);
+}
+
+TEST(ArcInputBridgeCoalescerTest, KeyIsBarrier) {
+    BridgeInputEvent key = BridgeInputEvent::KeyEvent(0, 30, 1, 0);
+    EXPECT_EQ(4u, Coalesce({TouchMove(0, 1), key, TouchMove(0, 2), TouchFrame()}).size());
+}
+
+TEST(ArcInputBridgeCoalescerTest, FrameIsBarrierByDefault) {
+    EXPECT_EQ(4u, Coalesce({Move(1), Frame(), Move(2), Frame()}).size());
+}
+
+TEST(ArcInputBridgeCoalescerTest, FoldsMoveOnlyFrames) {
+    std::vector<BridgeInputEvent> out =
+            Coalesce({Move(1), Frame(), Move(2), Frame(), Move(3), Frame()}, true);
+    ASSERT_EQ(2u, out.size());
+    EXPECT_EQ(3, out[0].pointer.x);
+    EXPECT_EQ(InputEventType::POINTER_FRAME, out[1].type);
+}
+
+TEST(ArcInputBridgeCoalescerTest, NeverFoldsFrameWithButton) {
+    std::vector<BridgeInputEvent> in = {Move(1), Button(), Frame(), Move(2), Frame()};
+    EXPECT_EQ(Types(in), Types(Coalesce(in, true)));
+}
+
+TEST(ArcInputBridgeCoalescerTest, NeverFoldsFramesOfOtherFamilies) {
+    std::vector<BridgeInputEvent> in = {TouchMove(0, 1), TouchFrame(), Move(2), Frame()};
+    EXPECT_EQ(Types(in), Types(Coalesce(in, true)));
+}
+
+TEST(ArcInputBridgeCoalescerTest, CountsFoldedEvents) {
+    BridgeInputCoalescer coalescer;
+    std::vector<BridgeInputEvent> events = {Move(1), Move(2), TouchMove(0, 1), TouchMove(0, 2)};
+    EXPECT_EQ(2u, coalescer.Coalesce(events.data(), events.size()));
+    EXPECT_EQ(4u, coalescer.stats().eventsIn);
+    EXPECT_EQ(2u, coalescer.stats().eventsOut);
+    EXPECT_EQ(1u, coalescer.stats().foldedPointerMoves);
+    EXPECT_EQ(1u, coalescer.stats().foldedTouchMoves);
+}
+
+}  // namespace
+}  // namespace arc
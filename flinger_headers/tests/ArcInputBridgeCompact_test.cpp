@@ -0,0 +1,154 @@
+/*
+ * Copyright 2026 The Chromium Authors.
+ *
+ * Permission is hereby granted, free of charge, to any person obtaining a
+ * copy of this software and associated documentation files (the "Software"),
+ * to deal in the Software without restriction, including without limitation
+ * the rights to use, copy, modify, merge, publish, distribute, sublicense,
+ * and/or sell copies of the Software, and to permit persons to whom the
+ * Software is furnished to do so, subject to the following conditions:
+ *
+ * The above copyright notice and this permission notice (including the next
+ * paragraph) shall be included in all copies or substantial portions of the
+ * Software.
+ *
+ * THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+ * IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+ * FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL
+ * THE AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+ * LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING
+ * FROM, OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER
+ * DEALINGS IN THE SOFTWARE.
+ */
+
+#include <cstdint>
+#include <cstring>
+#include <vector>
+
+#include <gtest/gtest.h>
+
+#include "ArcInputBridgeProtocol.h"
+#include "ArcInputBridgeStream.h"
+
+namespace arc {
+namespace {
+
+// One event of every type a BridgeInputEvent holds, with its args filled
+// with a pattern and the rest of the union zeroed, as the factories leave it.
+std::vector<BridgeInputEvent> MakeEventOfEveryType() {
+    std::vector<BridgeInputEvent> events;
+#define ARC_ADD_EVENT(eventType, argsType, member) \
+    events.push_back({1000 + events.size(), 7, InputEventType::eventType, {}});
+    ARC_INPUT_BRIDGE_EVENT_TYPES(ARC_ADD_EVENT)
+#undef ARC_ADD_EVENT
+    for (BridgeInputEvent& event : events) {
+        if (event.type == InputEventType::GAMEPAD_SNAPSHOT) {
+            // The pattern would claim more values than fit.
+            event.gamepad_snapshot.id = 3;
+            event.gamepad_snapshot.changedAxes = 0x5;
+            event.gamepad_snapshot.changedButtons = 0x1;
+            event.gamepad_snapshot.values[0] = 0.5f;
+            event.gamepad_snapshot.values[1] = -1;
+            event.gamepad_snapshot.values[2] = 1;
+            continue;
+        }
+        uint8_t* args = reinterpret_cast<uint8_t*>(&event) + offsetof(BridgeInputEvent, pointer);
+        for (size_t i = 0; i < BridgeInputEvent::ArgsSize(event.type); i++) {
+            args[i] = static_cast<uint8_t>(i * 7 + 1);
+        }
+    }
+    return events;
+}
+
+TEST(ArcInputBridgeCompactTest, RoundTripsEveryType) {
+    for (const BridgeInputEvent& event : MakeEventOfEveryType()) {
+        SCOPED_TRACE(static_cast<int>(event.type));
+        uint8_t buffer[sizeof(BridgeInputEvent) + sizeof(BridgeInputEventCompactHeader)];
+        size_t size = event.EncodeCompact(buffer, sizeof(buffer));
+        ASSERT_EQ(event.CompactSize(), size);
+        ASSERT_LE(size, BridgeInputEvent::kMaxCompactSize);
+
+        BridgeInputEvent decoded;
+        memset(&decoded, 0xff, sizeof(decoded));
+        ASSERT_EQ(size, BridgeInputEvent::DecodeCompact(buffer, size, &decoded));
+        EXPECT_EQ(0, memcmp(&event, &decoded, sizeof(event)));
+    }
+}
+
+TEST(ArcInputBridgeCompactTest, RejectsShortBuffers) {
+    BridgeInputEvent event = BridgeInputEvent::KeyEvent(1, 30, 1, 2);
+    uint8_t buffer[sizeof(BridgeInputEvent)];
+    size_t size = event.EncodeCompact(buffer, sizeof(buffer));
+    ASSERT_GT(size, 0u);
+    EXPECT_EQ(0u, event.EncodeCompact(buffer, size - 1));
+
+    BridgeInputEvent decoded;
+    EXPECT_EQ(0u, BridgeInputEvent::DecodeCompact(buffer, size - 1, &decoded));
+    EXPECT_EQ(0u, BridgeInputEvent::DecodeCompact(buffer, 3, &decoded));
+}
+
+TEST(ArcInputBridgeCompactTest, RejectsBadLength) {
+    BridgeInputEvent event = BridgeInputEvent::KeyEvent(1, 30, 1, 2);
+    uint8_t buffer[sizeof(BridgeInputEvent)];
+    size_t size = event.EncodeCompact(buffer, sizeof(buffer));
+    BridgeInputEvent decoded;
+    BridgeInputEventCompactHeader header;
+    memcpy(&header, buffer, sizeof(header));
+    header.length = sizeof(header) - 1;
+    memcpy(buffer, &header, sizeof(header));
+    EXPECT_EQ(0u, BridgeInputEvent::DecodeCompact(buffer, size, &decoded));
+}
+
+// Whether the stream decoder hands |type| out as it is. It consumes
+// WIRE_FORMAT and expands *_REF events through its metadata table.
+bool IsPassedThrough(InputEventType type) {
+    return type != InputEventType::WIRE_FORMAT &&
+            type != InputEventType::GAMEPAD_CONNECTED_REF &&
+            type != InputEventType::KEY_CHARACTER_MAP_NAME_REF;
+}
+
+// A legacy prefix, WIRE_FORMAT, then compact records, fed to the stream
+// decoder one byte at a time so every record arrives in pieces.
+TEST(ArcInputBridgeCompactTest, StreamDecoderFollowsWireFormat) {
+    std::vector<BridgeInputEvent> events;
+    for (const BridgeInputEvent& event : MakeEventOfEveryType()) {
+        if (IsPassedThrough(event.type)) {
+            events.push_back(event);
+        }
+    }
+    std::vector<uint8_t> stream;
+    auto appendLegacy = [&stream](const BridgeInputEvent& event) {
+        const uint8_t* bytes = reinterpret_cast<const uint8_t*>(&event);
+        stream.insert(stream.end(), bytes, bytes + sizeof(event));
+    };
+    appendLegacy(BridgeInputEvent::KeyEvent(1, 30, 1, 2));
+    appendLegacy(BridgeInputEvent::WireFormatEvent(2, kArcInputBridgeWireVersionCompact));
+    for (const BridgeInputEvent& event : events) {
+        uint8_t buffer[sizeof(BridgeInputEvent) + sizeof(BridgeInputEventCompactHeader)];
+        size_t size = event.EncodeCompact(buffer, sizeof(buffer));
+        stream.insert(stream.end(), buffer, buffer + size);
+    }
+
+    BridgeInputStreamDecoder decoder;
+    std::vector<BridgeInputEvent> decoded;
+    for (uint8_t byte : stream) {
+        ASSERT_EQ(1u, decoder.Append(&byte, 1));
+        BridgeInputEvent event;
+        while (decoder.Next(&event)) {
+            decoded.push_back(event);
+        }
+    }
+    EXPECT_FALSE(decoder.corrupt());
+    EXPECT_EQ(0u, decoder.buffered());
+    EXPECT_EQ(kArcInputBridgeWireVersionCompact, decoder.wireVersion());
+
+    ASSERT_EQ(events.size() + 1, decoded.size());
+    EXPECT_EQ(InputEventType::KEY, decoded[0].type);
+    for (size_t i = 0; i < events.size(); i++) {
+        SCOPED_TRACE(static_cast<int>(events[i].type));
+        EXPECT_EQ(0, memcmp(&events[i], &decoded[i + 1], sizeof(BridgeInputEvent)));
+    }
+}
+
+}  // namespace
+}  // namespace arc
@@ -0,0 +1,111 @@
+/*
+ * Copyright 2026 The Chromium Authors.
+ *
+ * Permission is hereby granted, free of charge, to any person obtaining a
+ * copy of this software and associated documentation files (the "Software"),
+ * to deal in the Software without restriction, including without limitation
+ * the rights to use, copy, modify, merge, publish, distribute, sublicense,
+ * and/or sell copies of the Software, and to permit persons to whom the
+ * Software is furnished to do so, subject to the following conditions:
+ *
+ * The above copyright notice and this permission notice (including the next
+ * paragraph) shall be included in all copies or substantial portions of the
+ * Software.
+ *
+ * THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+ * IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+ * FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL
+ * THE AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+ * LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING
+ * FROM, OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER
+ * DEALINGS IN THE SOFTWARE.
+ */
+
+#include <sched.h>
+
+#include <atomic>
+#include <cstdint>
+#include <thread>
+#include <vector>
+
+#include <gtest/gtest.h>
+
+#include "ArcInputBridgeMpscQueue.h"
+
+namespace arc {
+namespace {
+
+TEST(ArcInputBridgeMpscQueueTest, RoundsCapacityUp) {
+    EXPECT_EQ(2u, BridgeInputMpscQueue(1).capacity());
+    EXPECT_EQ(8u, BridgeInputMpscQueue(5).capacity());
+    EXPECT_EQ(1024u, BridgeInputMpscQueue(1024).capacity());
+    EXPECT_FALSE(BridgeInputMpscQueue(0).IsValid());
+}
+
+TEST(ArcInputBridgeMpscQueueTest, FullQueueRejectsPush) {
+    BridgeInputMpscQueue queue(4);
+    ASSERT_TRUE(queue.IsValid());
+    BridgeInputMpscQueue::Producer producer(&queue, 0);
+    for (uint64_t i = 0; i < 4; i++) {
+        ASSERT_TRUE(producer.Push(BridgeInputEvent::ResetEvent(i)));
+    }
+    EXPECT_FALSE(producer.Push(BridgeInputEvent::ResetEvent(4)));
+    EXPECT_EQ(1u, producer.stats().full);
+
+    BridgeInputEvent event;
+    ASSERT_TRUE(queue.Pop(&event));
+    EXPECT_EQ(0u, event.timestamp);
+    EXPECT_TRUE(producer.Push(BridgeInputEvent::ResetEvent(4)));
+}
+
+// Several producers push numbered events into a small queue while the
+// consumer drains it. Every producer's events must come out complete and in
+// the order it pushed them, however they interleave.
+TEST(ArcInputBridgeMpscQueueTest, KeepsPerSourceOrderAcrossThreads) {
+    constexpr uint32_t kProducers = 4;
+    constexpr uint64_t kEventsPerProducer = 20000;
+    BridgeInputMpscQueue queue(64);
+    ASSERT_TRUE(queue.IsValid());
+
+    std::atomic<bool> stop{false};
+    std::vector<std::thread> threads;
+    for (uint32_t source = 0; source < kProducers; source++) {
+        threads.emplace_back([&queue, &stop, source] {
+            BridgeInputMpscQueue::Producer producer(&queue, source);
+            for (uint64_t i = 0; i < kEventsPerProducer && !stop;) {
+                if (producer.Push(BridgeInputEvent::ResetEvent(i))) {
+                    i++;
+                } else {
+                    sched_yield();
+                }
+            }
+        });
+    }
+
+    // A failure only ends the loop, so that the producers are always joined.
+    std::vector<uint64_t> next(kProducers, 0);
+    uint64_t remaining = kProducers * kEventsPerProducer;
+    bool ordered = true;
+    while (remaining > 0 && ordered && queue.Wait(5000)) {
+        BridgeInputEvent event;
+        uint32_t source;
+        while (ordered && queue.Pop(&event, &source)) {
+            ordered = source < kProducers && event.timestamp == next[source];
+            next[source % kProducers]++;
+            remaining--;
+        }
+    }
+    stop = true;
+    for (std::thread& thread : threads) {
+        thread.join();
+    }
+    EXPECT_TRUE(ordered);
+    for (uint32_t source = 0; source < kProducers; source++) {
+        EXPECT_EQ(kEventsPerProducer, next[source]) << "source " << source;
+    }
+    BridgeInputEvent event;
+    EXPECT_FALSE(queue.Pop(&event));
+}
+
+}  // namespace
+}  // namespace arc
@@ -0,0 +1,131 @@
+/*
+ * Copyright 2026 The Chromium Authors.
+ *
+ * Permission is hereby granted, free of charge, to any person obtaining a
+ * copy of this software and associated documentation files (the "Software"),
+ * to deal in the Software without restriction, including without limitation
+ * the rights to use, copy, modify, merge, publish, distribute, sublicense,
+ * and/or sell copies of the Software, and to permit persons to whom the
+ * Software is furnished to do so, subject to the following conditions:
+ *
+ * The above copyright notice and this permission notice (including the next
+ * paragraph) shall be included in all copies or substantial portions of the
+ * Software.
+ *
+ * THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+ * IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+ * FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL
+ * THE AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+ * LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING
+ * FROM, OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER
+ * DEALINGS IN THE SOFTWARE.
+ */
+
+#include <fcntl.h>
+#include <poll.h>
+#include <unistd.h>
+
+#include <cstdint>
+
+#include <gtest/gtest.h>
+
+#include "ArcInputBridgeRing.h"
+
+namespace arc {
+namespace {
+
+BridgeInputEvent Key(uint64_t timestamp) {
+    return BridgeInputEvent::KeyEvent(timestamp, 30, 1, 0);
+}
+
+bool IsReadable(int fd) {
+    pollfd pfd{fd, POLLIN, 0};
+    return TEMP_FAILURE_RETRY(poll(&pfd, 1, 0)) == 1;
+}
+
+class ArcInputBridgeRingTest : public testing::Test {
+protected:
+    void Attach(uint32_t capacity) {
+        ASSERT_TRUE(mWriter.Create(capacity));
+        ASSERT_TRUE(mReader.Attach(fcntl(mWriter.memFd(), F_DUPFD_CLOEXEC, 0),
+                                   fcntl(mWriter.eventFd(), F_DUPFD_CLOEXEC, 0)));
+    }
+
+    BridgeInputRingWriter mWriter;
+    BridgeInputRingReader mReader;
+};
+
+TEST_F(ArcInputBridgeRingTest, RejectsInvalidCapacity) {
+    EXPECT_FALSE(mWriter.Create(0));
+    EXPECT_FALSE(mWriter.Create(3));
+    EXPECT_FALSE(mWriter.Create(kArcInputBridgeRingMaxCapacity * 2));
+}
+
+TEST_F(ArcInputBridgeRingTest, WrapsAroundInOrder) {
+    Attach(4);
+    uint64_t written = 0;
+    uint64_t read = 0;
+    // Three events per round never line up with the capacity, so the indices
+    // wrap at every slot.
+    for (int round = 0; round < 100; round++) {
+        for (int i = 0; i < 3; i++) {
+            ASSERT_TRUE(mWriter.Write(Key(written++)));
+        }
+        BridgeInputEvent event;
+        while (mReader.Read(&event)) {
+            EXPECT_EQ(read++, event.timestamp);
+        }
+    }
+    EXPECT_EQ(written, read);
+}
+
+TEST_F(ArcInputBridgeRingTest, FullRingRejectsWrites) {
+    Attach(4);
+    for (uint64_t i = 0; i < 4; i++) {
+        ASSERT_TRUE(mWriter.Write(Key(i)));
+    }
+    EXPECT_FALSE(mWriter.Write(Key(4)));
+
+    BridgeInputEvent event;
+    ASSERT_TRUE(mReader.Read(&event));
+    EXPECT_EQ(0u, event.timestamp);
+    EXPECT_TRUE(mWriter.Write(Key(4)));
+    for (uint64_t i = 1; i <= 4; i++) {
+        ASSERT_TRUE(mReader.Read(&event));
+        EXPECT_EQ(i, event.timestamp);
+    }
+    EXPECT_FALSE(mReader.Read(&event));
+}
+
+TEST_F(ArcInputBridgeRingTest, DoorbellRingsOnlyWhenEmpty) {
+    Attach(8);
+    EXPECT_FALSE(IsReadable(mReader.eventFd()));
+    EXPECT_FALSE(mReader.Wait(0));
+
+    ASSERT_TRUE(mWriter.Write(Key(0)));
+    ASSERT_TRUE(mWriter.Write(Key(1)));
+    ASSERT_TRUE(IsReadable(mReader.eventFd()));
+    uint64_t count = 0;
+    ASSERT_EQ(static_cast<ssize_t>(sizeof(count)),
+              TEMP_FAILURE_RETRY(read(mReader.eventFd(), &count, sizeof(count))));
+    // The second write found the ring non-empty and didn't ring again.
+    EXPECT_EQ(1u, count);
+
+    // Not drained yet, so a further write stays silent.
+    BridgeInputEvent event;
+    ASSERT_TRUE(mReader.Read(&event));
+    ASSERT_TRUE(mWriter.Write(Key(2)));
+    EXPECT_FALSE(IsReadable(mReader.eventFd()));
+    EXPECT_TRUE(mReader.Wait(0));
+
+    // Once drained, the next write rings again.
+    while (mReader.Read(&event)) {
+    }
+    EXPECT_FALSE(mReader.Wait(0));
+    ASSERT_TRUE(mWriter.Write(Key(3)));
+    EXPECT_TRUE(IsReadable(mReader.eventFd()));
+    EXPECT_TRUE(mReader.Wait(0));
+}
+
+}  // namespace
+}  // namespace arc
@@ -0,0 +1,167 @@
+/*
+ * Copyright 2026 The Chromium Authors.
+ *
+ * Permission is hereby granted, free of charge, to any person obtaining a
+ * copy of this software and associated documentation files (the "Software"),
+ * to deal in the Software without restriction, including without limitation
+ * the rights to use, copy, modify, merge, publish, distribute, sublicense,
+ * and/or sell copies of the Software, and to permit persons to whom the
+ * Software is furnished to do so, subject to the following conditions:
+ *
+ * The above copyright notice and this permission notice (including the next
+ * paragraph) shall be included in all copies or substantial portions of the
+ * Software.
+ *
+ * THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+ * IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+ * FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL
+ * THE AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+ * LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING
+ * FROM, OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER
+ * DEALINGS IN THE SOFTWARE.
+ */
+
+#include <algorithm>
+#include <cmath>
+#include <cstdint>
+#include <vector>
+
+#include <gtest/gtest.h>
+
+#include "ArcInputBridgeStream.h"
+#include "ArcInputBridgeTouchDelta.h"
+
+namespace arc {
+namespace {
+
+// |contacts| fingers moving together, each offset by its id.
+std::vector<BridgeInputEvent> Frame(uint64_t timestamp, uint32_t contacts, float position) {
+    std::vector<BridgeInputEvent> frame;
+    for (uint32_t id = 0; id < contacts; id++) {
+        BridgeInputEvent move{timestamp, 0, InputEventType::TOUCH_MOVE, {}};
+        move.touch.id = id;
+        move.touch.x = position + id * 100;
+        move.touch.y = position * 2;
+        frame.push_back(move);
+    }
+    frame.push_back({timestamp, 0, InputEventType::TOUCH_FRAME, {}});
+    return frame;
+}
+
+void ExpectSameFrame(const std::vector<BridgeInputEvent>& expected,
+                     const BridgeInputEvent* actual) {
+    for (size_t i = 0; i < expected.size(); i++) {
+        SCOPED_TRACE(i);
+        EXPECT_EQ(expected[i].type, actual[i].type);
+        EXPECT_EQ(expected[i].timestamp, actual[i].timestamp);
+        EXPECT_EQ(expected[i].displayId, actual[i].displayId);
+        if (expected[i].type == InputEventType::TOUCH_MOVE) {
+            EXPECT_EQ(expected[i].touch.id, actual[i].touch.id);
+            EXPECT_NEAR(expected[i].touch.x, actual[i].touch.x, 0.5f / kTouchDeltaQuantization);
+            EXPECT_NEAR(expected[i].touch.y, actual[i].touch.y, 0.5f / kTouchDeltaQuantization);
+        }
+    }
+}
+
+TEST(ArcInputBridgeTouchDeltaTest, RoundTripsFrames) {
+    BridgeInputTouchDeltaEncoder encoder;
+    BridgeInputTouchDeltaDecoder decoder;
+    // Long enough to cross a forced keyframe; the steps don't fall on the
+    // quantization grid, so error would accumulate if the encoder didn't
+    // track the decoded positions.
+    for (uint32_t i = 0; i < kTouchDeltaKeyframeInterval * 2 + 5; i++) {
+        std::vector<BridgeInputEvent> frame = Frame(1000 + i * 8, 5, i * 0.37f);
+        std::vector<uint8_t> bytes;
+        ASSERT_TRUE(encoder.EncodeFrame(frame.data(), frame.size(), &bytes));
+        std::vector<BridgeInputEvent> decoded;
+        ASSERT_EQ(bytes.size(), decoder.DecodeFrame(bytes.data(), bytes.size(), &decoded));
+        ASSERT_EQ(frame.size(), decoded.size());
+        ExpectSameFrame(frame, decoded.data());
+    }
+}
+
+TEST(ArcInputBridgeTouchDeltaTest, DeltasAreSmallerThanKeyframes) {
+    BridgeInputTouchDeltaEncoder encoder;
+    std::vector<BridgeInputEvent> frame = Frame(1000, 10, 0);
+    std::vector<uint8_t> keyframe;
+    ASSERT_TRUE(encoder.EncodeFrame(frame.data(), frame.size(), &keyframe));
+    frame = Frame(1008, 10, 1);
+    std::vector<uint8_t> delta;
+    ASSERT_TRUE(encoder.EncodeFrame(frame.data(), frame.size(), &delta));
+    EXPECT_LT(delta.size() * 2, keyframe.size());
+}
+
+TEST(ArcInputBridgeTouchDeltaTest, RejectsDeltaWithoutKeyframe) {
+    BridgeInputTouchDeltaEncoder encoder;
+    std::vector<uint8_t> keyframe;
+    std::vector<uint8_t> delta;
+    std::vector<BridgeInputEvent> frame = Frame(1, 2, 0);
+    ASSERT_TRUE(encoder.EncodeFrame(frame.data(), frame.size(), &keyframe));
+    frame = Frame(2, 2, 1);
+    ASSERT_TRUE(encoder.EncodeFrame(frame.data(), frame.size(), &delta));
+
+    BridgeInputTouchDeltaDecoder decoder;
+    std::vector<BridgeInputEvent> decoded;
+    EXPECT_FALSE(decoder.DecodeRecord(delta.data(), delta.size(), &decoded));
+    EXPECT_EQ(1u, decoder.rejectedFrames());
+    EXPECT_TRUE(decoder.DecodeRecord(keyframe.data(), keyframe.size(), &decoded));
+    EXPECT_TRUE(decoder.DecodeRecord(delta.data(), delta.size(), &decoded));
+    ASSERT_EQ(6u, decoded.size());
+    ExpectSameFrame(frame, decoded.data() + 3);
+}
+
+TEST(ArcInputBridgeTouchDeltaTest, RejectsFramesOverRecordLimit) {
+    BridgeInputTouchDeltaEncoder encoder;
+    uint8_t record[BridgeInputEvent::kMaxCompactSize];
+    std::vector<BridgeInputEvent> frame = Frame(1, kTouchDeltaMaxRecordContacts, 0);
+    EXPECT_GT(encoder.EncodeRecord(frame.data(), frame.size(), record, sizeof(record)), 0u);
+    frame = Frame(2, kTouchDeltaMaxRecordContacts + 1, 0);
+    EXPECT_EQ(0u, encoder.EncodeRecord(frame.data(), frame.size(), record, sizeof(record)));
+}
+
+// TOUCH_DELTA_FRAME records on a compact stream, with a RESET in the middle
+// after which the producer sends a keyframe.
+TEST(ArcInputBridgeTouchDeltaTest, StreamDecoderExpandsRecords) {
+    std::vector<uint8_t> stream;
+    BridgeInputEvent wireFormat =
+            BridgeInputEvent::WireFormatEvent(0, kArcInputBridgeWireVersionCompact);
+    const uint8_t* bytes = reinterpret_cast<const uint8_t*>(&wireFormat);
+    stream.insert(stream.end(), bytes, bytes + sizeof(wireFormat));
+
+    BridgeInputTouchDeltaEncoder encoder;
+    std::vector<BridgeInputEvent> expected;
+    uint8_t record[BridgeInputEvent::kMaxCompactSize];
+    for (uint32_t i = 0; i < 20; i++) {
+        std::vector<BridgeInputEvent> frame = Frame(1000 + i * 8, 10, i * 0.5f);
+        size_t size = encoder.EncodeRecord(frame.data(), frame.size(), record, sizeof(record));
+        ASSERT_GT(size, 0u);
+        stream.insert(stream.end(), record, record + size);
+        expected.insert(expected.end(), frame.begin(), frame.end());
+        if (i == 10) {
+            BridgeInputEvent reset = BridgeInputEvent::ResetEvent(2000);
+            size = reset.EncodeCompact(record, sizeof(record));
+            stream.insert(stream.end(), record, record + size);
+            expected.push_back(reset);
+            encoder.RequestKeyframe();
+        }
+    }
+
+    BridgeInputStreamDecoder decoder;
+    std::vector<BridgeInputEvent> decoded;
+    for (size_t offset = 0; offset < stream.size();) {
+        // Odd chunks, so records arrive split.
+        size_t chunk = std::min<size_t>(33, stream.size() - offset);
+        offset += decoder.Append(stream.data() + offset, chunk);
+        BridgeInputEvent event;
+        while (decoder.Next(&event)) {
+            decoded.push_back(event);
+        }
+    }
+    EXPECT_FALSE(decoder.corrupt());
+    EXPECT_EQ(0u, decoder.touchDelta().rejectedFrames());
+    ASSERT_EQ(expected.size(), decoded.size());
+    ExpectSameFrame(expected, decoded.data());
+}
+
+}  // namespace
+}  // namespace arc
@@ -0,0 +1,193 @@
+/*
+ * Copyright 2026 The Chromium Authors.
+ *
+ * Permission is hereby granted, free of charge, to any person obtaining a
+ * copy of this software and associated documentation files (the "Software"),
+ * to deal in the Software without restriction, including without limitation
+ * the rights to use, copy, modify, merge, publish, distribute, sublicense,
+ * and/or sell copies of the Software, and to permit persons to whom the
+ * Software is furnished to do so, subject to the following conditions:
+ *
+ * The above copyright notice and this permission notice (including the next
+ * paragraph) shall be included in all copies or substantial portions of the
+ * Software.
+ *
+ * THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+ * IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+ * FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL
+ * THE AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+ * LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING
+ * FROM, OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER
+ * DEALINGS IN THE SOFTWARE.
+ */
+
+// Records and replays BridgeInputEvent streams.
+//
+//   inputbridge_capture record <capture> [<source-pipe> [<forward-pipe>]]
+//   inputbridge_capture play [--fast] [--ring] <capture> [<pipe>]
+//
+// record reads events from <source-pipe> (kArcInputBridgePipe by default)
+// until EOF or SIGINT, following WIRE_FORMAT switches, and optionally
+// forwards the stream unchanged to <forward-pipe> so the real consumer keeps
+// working while recording.
+//
+// play re-injects a capture into <pipe> (kArcInputBridgePipe by default), or
+// into a shared memory ring handed to the consumer on
+// kArcInputBridgeRingSocket with --ring. With --fast events are sent back to
+// back and the achieved throughput is reported.
+
+#include <fcntl.h>
+#include <limits.h>
+#include <sched.h>
+#include <signal.h>
+#include <unistd.h>
+
+#include <cinttypes>
+#include <cstdio>
+#include <cstring>
+
+#include "ArcInputBridgeCapture.h"
+#include "ArcInputBridgeRing.h"
+#include "ArcInputBridgeStream.h"
+
+namespace {
+
+volatile sig_atomic_t gStop = 0;
+
+void OnSignal(int) {
+    gStop = 1;
+}
+
+int Usage() {
+    fprintf(stderr,
+            "usage: inputbridge_capture record <capture> [<source-pipe> [<forward-pipe>]]\n"
+            "       inputbridge_capture play [--fast] [--ring] <capture> [<pipe>]\n");
+    return 1;
+}
+
+int Record(int argc, char** argv) {
+    if (argc < 1 || argc > 3) {
+        return Usage();
+    }
+    const char* source = argc > 1 ? argv[1] : arc::kArcInputBridgePipe;
+    int out = open(argv[0], O_WRONLY | O_CREAT | O_TRUNC | O_CLOEXEC, 0644);
+    int in = open(source, O_RDONLY | O_CLOEXEC);
+    int forward = argc > 2 ? open(argv[2], O_WRONLY | O_CLOEXEC) : -1;
+    if (out < 0 || in < 0 || (argc > 2 && forward < 0)) {
+        perror("inputbridge_capture: open");
+        return 1;
+    }
+
+    // No SA_RESTART, so a blocked read returns EINTR on ^C.
+    struct sigaction sa = {};
+    sa.sa_handler = OnSignal;
+    sigaction(SIGINT, &sa, nullptr);
+    sigaction(SIGTERM, &sa, nullptr);
+
+    arc::BridgeInputCaptureWriter writer(out);
+    if (!writer.WriteHeader()) {
+        perror("inputbridge_capture: write");
+        return 1;
+    }
+    uint64_t count = 0;
+    arc::BridgeInputStreamDecoder decoder;
+    arc::BridgeInputEvent event;
+    uint8_t buffer[PIPE_BUF];
+    ssize_t n;
+    while (!gStop && !decoder.corrupt() && (n = read(in, buffer, sizeof(buffer))) > 0) {
+        // Forward the bytes as they came, WIRE_FORMAT events included, so the
+        // consumer decodes the same stream we do.
+        if (forward >= 0 && !arc::BridgeInputCaptureWriteFully(forward, buffer, n)) {
+            perror("inputbridge_capture: forward");
+            break;
+        }
+        for (size_t offset = 0; offset < size_t(n) && !decoder.corrupt();) {
+            offset += decoder.Append(buffer + offset, n - offset);
+            while (decoder.Next(&event)) {
+                writer.Append(event);
+                count++;
+            }
+        }
+    }
+    if (decoder.corrupt()) {
+        fprintf(stderr, "inputbridge_capture: %s sent a record that can't be decoded\n", source);
+    }
+    writer.Flush();
+    fprintf(stderr, "recorded %" PRIu64 " events\n", count);
+    return 0;
+}
+
+int Play(int argc, char** argv) {
+    arc::BridgeInputCapturePlayer::Options options;
+    bool useRing = false;
+    while (argc > 0 && argv[0][0] == '-') {
+        if (strcmp(argv[0], "--fast") == 0) {
+            options.mode = arc::BridgeInputCapturePlayer::Mode::AS_FAST_AS_POSSIBLE;
+        } else if (strcmp(argv[0], "--ring") == 0) {
+            useRing = true;
+        } else {
+            return Usage();
+        }
+        argc--;
+        argv++;
+    }
+    if (argc < 1 || argc > 2 || (useRing && argc > 1)) {
+        return Usage();
+    }
+
+    int in = open(argv[0], O_RDONLY | O_CLOEXEC);
+    if (in < 0) {
+        perror("inputbridge_capture: open");
+        return 1;
+    }
+    arc::BridgeInputCaptureReader reader(in);
+    if (!reader.ReadHeader()) {
+        fprintf(stderr, "inputbridge_capture: %s is not a compatible capture\n", argv[0]);
+        return 1;
+    }
+
+    arc::BridgeInputRingWriter ring;
+    arc::BridgeInputCapturePlayer::Sink sink;
+    if (useRing) {
+        if (!ring.Create() || !ring.SendToConsumer()) {
+            fprintf(stderr, "inputbridge_capture: could not hand a ring to the consumer\n");
+            return 1;
+        }
+        // The ring never blocks, so wait for the consumer to make room.
+        sink = [&ring](const arc::BridgeInputEvent& event) {
+            while (!ring.Write(event)) {
+                sched_yield();
+            }
+            return true;
+        };
+    } else {
+        int out = open(argc > 1 ? argv[1] : arc::kArcInputBridgePipe, O_WRONLY | O_CLOEXEC);
+        if (out < 0) {
+            perror("inputbridge_capture: open");
+            return 1;
+        }
+        sink = arc::BridgeInputCapturePlayer::PipeSink(out);
+    }
+
+    arc::BridgeInputCapturePlayer::Result result =
+            arc::BridgeInputCapturePlayer::Play(&reader, sink, options);
+    double seconds = result.elapsedNs / 1e9;
+    printf("events=%" PRIu64 " elapsed_s=%.6f events_per_s=%.0f\n", result.events, seconds,
+           seconds > 0 ? result.events / seconds : 0.0);
+    return 0;
+}
+
+}  // namespace
+
+int main(int argc, char** argv) {
+    if (argc < 2) {
+        return Usage();
+    }
+    if (strcmp(argv[1], "record") == 0) {
+        return Record(argc - 2, argv + 2);
+    }
+    if (strcmp(argv[1], "play") == 0) {
+        return Play(argc - 2, argv + 2);
+    }
+    return Usage();
+}